@@ -0,0 +1,190 @@
+#include <cstdio>
+
+#include "Checkpoint.h"
+
+#if !defined(_WIN32)
+#	include <unistd.h>
+#endif
+
+using namespace core;
+
+// -------------------------------------------------------------------------
+uint64 fnv1a(const void* data, size_t size, uint64 hash)
+{
+	const uint8* bytes = static_cast<const uint8*>(data);
+	for(size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+// -------------------------------------------------------------------------
+bool writeFileAtomic(const char* filename, const std::vector<char>& data)
+{
+	std::string tmpName = std::string(filename) + ".tmp";
+	FILE* fp = fopen(tmpName.c_str(), "wb");
+	if(!fp)
+	{
+		fprintf(stderr, "Error: couldn't open \"%s\" for writing\n", tmpName.c_str());
+		return false;
+	}
+
+	bool ok = data.empty() || fwrite(&data[0], 1, data.size(), fp) == data.size();
+	ok = fflush(fp) == 0 && ok;
+#if !defined(_WIN32)
+	// dane na dysku zanim stara wersja zostanie zastapiona
+	ok = fsync(fileno(fp)) == 0 && ok;
+#endif
+	ok = fclose(fp) == 0 && ok;
+
+	if(ok)
+	{
+#if defined(_WIN32)
+		// rename na Windows nie nadpisuje istniejacego pliku
+		remove(filename);
+#endif
+		ok = rename(tmpName.c_str(), filename) == 0;
+	}
+
+	if(!ok)
+	{
+		fprintf(stderr, "Error: couldn't write \"%s\"\n", filename);
+		remove(tmpName.c_str());
+	}
+	return ok;
+}
+// -------------------------------------------------------------------------
+bool readFile(const char* filename, std::vector<char>& data)
+{
+	FILE* fp = fopen(filename, "rb");
+	if(!fp)
+	{
+		fprintf(stderr, "Error: couldn't open \"%s\"\n", filename);
+		return false;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	data.resize(size > 0 ? size : 0);
+	bool ok = size >= 0 && (data.empty() || fread(&data[0], 1, data.size(), fp) == data.size());
+	fclose(fp);
+
+	if(!ok)
+		fprintf(stderr, "Error: couldn't read \"%s\"\n", filename);
+	return ok;
+}
+// -------------------------------------------------------------------------
+CheckpointWriter::CheckpointWriter()
+: hasPending(false), busy(false), quit(false), numWritten(0), numFailed(0), numReplaced(0)
+{
+#if !defined(_WIN32)
+	pthread_mutex_init(&mutex, 0);
+	pthread_cond_init(&cond, 0);
+	// watek startuje przy pierwszym zapisie
+	started = false;
+#endif
+}
+// -------------------------------------------------------------------------
+CheckpointWriter::~CheckpointWriter()
+{
+#if !defined(_WIN32)
+	if(started)
+	{
+		pthread_mutex_lock(&mutex);
+		quit = true;
+		pthread_cond_broadcast(&cond);
+		pthread_mutex_unlock(&mutex);
+		pthread_join(thread, 0);
+	}
+	pthread_cond_destroy(&cond);
+	pthread_mutex_destroy(&mutex);
+#endif
+}
+// -------------------------------------------------------------------------
+void CheckpointWriter::submit(const std::string& filename, std::vector<char>& data)
+{
+#if !defined(_WIN32)
+	pthread_mutex_lock(&mutex);
+	if(!started)
+	{
+		started = pthread_create(&thread, 0, &CheckpointWriter::threadMain, this) == 0;
+		if(!started)
+			fprintf(stderr, "Warning: couldn't start checkpoint thread, writing synchronously\n");
+	}
+
+	if(started)
+	{
+		if(hasPending)
+			++numReplaced;
+		pendingName = filename;
+		pending.swap(data);
+		data.clear();
+		hasPending = true;
+		pthread_cond_broadcast(&cond);
+		pthread_mutex_unlock(&mutex);
+		return;
+	}
+	pthread_mutex_unlock(&mutex);
+#endif
+
+	if(writeFileAtomic(filename.c_str(), data))
+		++numWritten;
+	else
+		++numFailed;
+	data.clear();
+}
+// -------------------------------------------------------------------------
+void CheckpointWriter::flush()
+{
+#if !defined(_WIN32)
+	pthread_mutex_lock(&mutex);
+	while(started && (hasPending || busy))
+		pthread_cond_wait(&cond, &mutex);
+	pthread_mutex_unlock(&mutex);
+#endif
+}
+// -------------------------------------------------------------------------
+#if !defined(_WIN32)
+void* CheckpointWriter::threadMain(void* arg)
+{
+	static_cast<CheckpointWriter*>(arg)->run();
+	return 0;
+}
+// -------------------------------------------------------------------------
+void CheckpointWriter::run()
+{
+	std::string name;
+	std::vector<char> data;
+
+	pthread_mutex_lock(&mutex);
+	for(;;)
+	{
+		while(!hasPending && !quit)
+			pthread_cond_wait(&cond, &mutex);
+		// przy zamykaniu oczekujacy obraz jest jeszcze zapisywany
+		if(!hasPending)
+			break;
+
+		name.swap(pendingName);
+		data.swap(pending);
+		hasPending = false;
+		busy = true;
+		pthread_mutex_unlock(&mutex);
+
+		bool ok = writeFileAtomic(name.c_str(), data);
+
+		pthread_mutex_lock(&mutex);
+		if(ok)
+			++numWritten;
+		else
+			++numFailed;
+		busy = false;
+		pthread_cond_broadcast(&cond);
+	}
+	pthread_mutex_unlock(&mutex);
+}
+#endif
+// -------------------------------------------------------------------------
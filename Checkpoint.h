@@ -0,0 +1,118 @@
+#pragma once
+
+#include "core/Prerequisites.h"
+
+#if !defined(_WIN32)
+#	include <pthread.h>
+#endif
+
+// * Zapis wartosci do bufora w pamieci (binarnie, w porzadku bajtow maszyny)
+class BinaryWriter
+{
+public:
+	BinaryWriter(std::vector<char>& data) : data(data) {}
+
+	template<typename T>
+	void put(const T& value)
+	{
+		put(&value, 1);
+	}
+
+	template<typename T>
+	void put(const T* values, size_t count)
+	{
+		const char* bytes = reinterpret_cast<const char*>(values);
+		data.insert(data.end(), bytes, bytes + count * sizeof(T));
+	}
+
+	size_t size() const { return data.size(); }
+
+private:
+	std::vector<char>& data;
+};
+
+// * Odczyt z bufora - po przekroczeniu konca kolejne odczyty zwracaja false
+class BinaryReader
+{
+public:
+	BinaryReader(const char* data, size_t size) : cursor(data), end(data + size) {}
+
+	template<typename T>
+	bool get(T& value)
+	{
+		return get(&value, 1);
+	}
+
+	template<typename T>
+	bool get(T* values, size_t count)
+	{
+		size_t bytes = count * sizeof(T);
+		if(static_cast<size_t>(end - cursor) < bytes)
+		{
+			cursor = end;
+			return false;
+		}
+		memcpy(values, cursor, bytes);
+		cursor += bytes;
+		return true;
+	}
+
+	size_t remaining() const { return end - cursor; }
+
+private:
+	const char* cursor;
+	const char* end;
+};
+
+// 64-bitowy skrot FNV-1a (suma kontrolna pliku, identyfikacja problemu)
+core::uint64 fnv1a(const void* data, size_t size, core::uint64 hash = 14695981039346656037ULL);
+
+// Zapisuje plik przez plik tymczasowy i zmiane nazwy - przerwany zapis
+// nie niszczy poprzedniej wersji
+bool writeFileAtomic(const char* filename, const std::vector<char>& data);
+bool readFile(const char* filename, std::vector<char>& data);
+
+// * Zapis obrazow stanu w osobnym watku - petla algorytmu tylko przekazuje
+//   gotowy bufor. Gdy poprzedni zapis jeszcze trwa, oczekujacy obraz jest
+//   zastepowany nowszym (zapisywany jest zawsze najnowszy).
+//   Bez pthreads (Windows) zapis jest synchroniczny.
+class CheckpointWriter
+{
+public:
+	CheckpointWriter();
+	// Czeka na zapis oczekujacego obrazu
+	~CheckpointWriter();
+
+	// Przekazuje obraz do zapisu, 'data' jest podmieniane (po wywolaniu puste)
+	void submit(const std::string& filename, std::vector<char>& data);
+	// Czeka az wszystkie przekazane obrazy zostana zapisane
+	void flush();
+
+	core::uint32 written() const { return numWritten; }
+	core::uint32 failed() const { return numFailed; }
+	// obrazy zastapione nowszymi zanim zdazyly zostac zapisane
+	core::uint32 replaced() const { return numReplaced; }
+
+private:
+	std::string pendingName;
+	std::vector<char> pending;
+	bool hasPending;
+	bool busy;
+	bool quit;
+	volatile core::uint32 numWritten;
+	volatile core::uint32 numFailed;
+	core::uint32 numReplaced;
+
+#if !defined(_WIN32)
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	bool started;
+
+	static void* threadMain(void* arg);
+	void run();
+#endif
+
+	CheckpointWriter(const CheckpointWriter&);
+	CheckpointWriter& operator=(const CheckpointWriter&);
+};
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <set>
 
 #if defined(EVO_QT_SUPPORT)
@@ -24,17 +25,6 @@ using namespace core;
 #	include <sys/time.h>
 #endif
 
-Genome::Genome(Problem& p)
-: objective(0xFFFFFFFF)
-{
-	rows.resize(p.numJobs);
-
-	for(uint32 i = 0; i < p.numJobs; ++i)
-	{
-		rows[i].genes.resize(p.jobs[i].numOps);
-	}
-}
-
 // zwraca indeks najwiekszego elementu w tablicy
 template<typename T>
 uint32 getMaxIdx(T* arr, uint32 arraysize)
@@ -53,6 +43,28 @@ uint32 getMaxIdx(T* arr, uint32 arraysize)
 	return maxId;
 }
 
+// Przenosi element sekwencji z pozycji 'from' na 'to', przesuwajac te pomiedzy
+inline void moveInSequence(uint16* seq, uint32 from, uint32 to)
+{
+	uint16 job = seq[from];
+	if(from < to)
+		memmove(seq + from, seq + from + 1, (to - from) * sizeof(uint16));
+	else if(from > to)
+		memmove(seq + to + 1, seq + to, (from - to) * sizeof(uint16));
+	seq[to] = job;
+}
+
+// Porzadek operacji wg czasu rozpoczecia (przy rownych - wg indeksu)
+struct StartTimeLess
+{
+	StartTimeLess(const uint32* times) : times(times) {}
+	bool operator()(uint32 a, uint32 b) const
+	{
+		return times[a] < times[b] || (times[a] == times[b] && a < b);
+	}
+	const uint32* times;
+};
+
 // Zwraca indeks najmniejszego elementu w tablicy
 uint32 getMinIdx(uint32* arr, uint32 arraysize)
 {
@@ -72,10 +84,15 @@ uint32 getMinIdx(uint32* arr, uint32 arraysize)
 
 // -------------------------------------------------------------------------
 Problem::Problem()
-: jobs(0), indexPop(0), replaceCoeff(0.1f), tempPopSize(0), numMachines(0), numJobs(0),
-maxOps(0), popModel(PM_SIMPLE), fitModel(FM_LINEARRANKING), genitor(true),
-sp(2.0f), probCX(0.0f), probMUT(0.0f),probOperator(0.5f), tourGroupSize(4), pickUnused(true),
-average(0.0f), maxObjective(0), minObjective(0),
+: jobs(0), hugePages(false), indexPop(0), generation(0), checkpointEvery(0), replaceCoeff(0.1f), tempPopSize(0),
+numMachines(0), numJobs(0), maxOps(0), numOps(0), geneBytes(1),
+jobBound(0), workloadBound(0), lowerBound(0), popModel(PM_SIMPLE), fitModel(FM_LINEARRANKING), decoder(DC_SEMIACTIVE), useSequence(false), genitor(true),
+boundedDecoding(false), decodeCutoff(NO_CUTOFF), acceptThreshold(NO_CUTOFF),
+screenFactor(0.0f), screenAuditPeriod(0), lsTopK(0), lsMaxIterations(0),
+sp(2.0f), probCX(0.0f), probMUT(0.0f),probOperator(0.5f),
+adaptive(false), adaptAlpha(0.3f), adaptBeta(0.3f), adaptMinProb(0.1f), adaptBudget(0.0f), operatorLog(0),
+stopReason(SR_NONE), bestObjective(0), bestGeneration(0), anytime(false), anytimePending(false), tourGroupSize(4), pickUnused(true),
+psum(0), choices(0), average(0.0f), maxObjective(0), minObjective(0),
 averageFitness(0.0f), maxFitness(0.0f), minFitness(0.0f)
 {
 #ifdef _WIN32
@@ -95,40 +112,51 @@ averageFitness(0.0f), maxFitness(0.0f), minFitness(0.0f)
 
 	pfnSelect = &Problem::selectUniform;
 	pfnNextGen = &Problem::nextGenSimple;
+
+	memset(perfGen, 0, sizeof(perfGen));
+	memset(perfTotal, 0, sizeof(perfTotal));
+	perfGenerations = 0;
+	memset(&lsStats, 0, sizeof(lsStats));
+	memset(opQuality, 0, sizeof(opQuality));
+	memset(opProb, 0, sizeof(opProb));
+	memset(opUses, 0, sizeof(opUses));
+
+	stopStart = omp_get_wtime();
+	omp_init_lock(&anytimeLock);
 }
 // -------------------------------------------------------------------------
 Problem::~Problem()
 {
 	clearData();
+	setOperatorLog(0);
+	omp_destroy_lock(&anytimeLock);
 }
 // -------------------------------------------------------------------------
 void Problem::clearData()
 {
+	clearAllSolutions();
+
 	colors.clear();
 	jobs.clear();
-
-	clearAllSolutions();
+	rowOffsets.clear();
+	defaultSequence.clear();
+	opJob.clear();
+	opMinCost.clear();
+	scratch.clear();
+	numOps = 0;
+	jobBound = workloadBound = lowerBound = 0;
 }
 // -------------------------------------------------------------------------
 void Problem::clearAllSolutions()
 {
-	for(Population::iterator it = pop.begin();
-		it != pop.end(); ++it)
-	{
-		delete *it;
-	}
-
-	for(Population::iterator it = tmpPop.begin();
-		it != tmpPop.end(); ++it)
-	{
-		delete *it;
-	}
-
 	pop.clear();
 	tmpPop.clear();
+	pool.destroy();
 
 	delete [] psum;
 	delete [] choices;
+	psum = 0;
+	choices = 0;
 }
 // -------------------------------------------------------------------------
 bool Problem::loadInitialData(const char* filename)
@@ -139,15 +167,25 @@ bool Problem::loadInitialData(const char* filename)
 		fprintf(stderr, "Error: couldn't open \"%s\"\n", filename);
 		return false;
 	}
+	return loadInitialData(file);
+}
+// -------------------------------------------------------------------------
+bool Problem::loadInitialData(std::istream& file)
+{
+	clearData();
+	numJobs = numMachines = 0;
 
-	char buff[512];
+	// wiersz kosztow ma numMachines liczb - bez limitu dlugosci linii
+	std::string line;
+	const char* buff = "";
 	int magic;
 	int currJob = 0;
 
 	while(!file.eof())
 	{
 		// przeczytaj cala linie
-		file.getline(buff, 512);
+		std::getline(file, line);
+		buff = line.c_str();
 
 		if(!strcmp(buff, "\r") && !strcmp(buff, "\n"))
 			continue;
@@ -158,13 +196,18 @@ bool Problem::loadInitialData(const char* filename)
 			{
 				// bad version
 				fprintf(stderr, "Error: bad file format.\n");
-				file.close();
 				return false;
 			}
 		}
 
 		else if(sscanf(buff, "numJobs %d", &numJobs) == 1)
 		{
+			// numer zadania musi zmiescic sie w sekwencji (2 bajty)
+			if(numJobs > 65536)
+			{
+				fprintf(stderr, "Error: too many jobs (%d).\n", numJobs);
+				return false;
+			}
 			if(numJobs)
 			{
 				jobs.resize(numJobs);
@@ -176,17 +219,30 @@ bool Problem::loadInitialData(const char* filename)
 
 		else if(sscanf(buff, "numMachines %d", &numMachines) == 1)
 		{
+			// numer maszyny musi zmiescic sie w genie (max. 2 bajty)
+			if(numMachines > 65536)
+			{
+				fprintf(stderr, "Error: too many machines (%d).\n", numMachines);
+				return false;
+			}
+			geneBytes = numMachines <= 256 ? 1 : 2;
 		}
 
 		else if(!strncmp(buff, "job {", 5))
 		{
+			if(currJob >= static_cast<int>(jobs.size()))
+			{
+				fprintf(stderr, "Error: more jobs than numJobs (%d).\n", numJobs);
+				return false;
+			}
 			Job* job = &jobs[currJob];
 			uint32 currentOps = 0;
 
 			while((buff[0] != '}') && !file.eof())
 			{
 				// przeczytaj nast. linijke
-				file.getline(buff, 512);
+				std::getline(file, line);
+				buff = line.c_str();
 
 				if(sscanf(buff, "\tnumOperations %d", &job->numOps) == 1)
 				{
@@ -204,16 +260,14 @@ bool Problem::loadInitialData(const char* filename)
 				else if(!strncmp(buff, "}", 1) == 1)
 					break;
 
-				else
+				else if(currentOps < job->numOps)
 				{
-					char* tmpBuf = buff;
+					const char* tmpBuf = buff;
 					for(uint32 k = 0; k < job->ops[currentOps].costs.size(); ++k)
 					{
-						sscanf(tmpBuf, "%d", &job->ops[currentOps].costs[k]);
-
-						char convBuf[32];
-						sprintf(convBuf, "%d", job->ops[currentOps].costs[k]);
-						tmpBuf += strlen(convBuf) + 1;
+						char* next;
+						job->ops[currentOps].costs[k] = static_cast<int>(strtol(tmpBuf, &next, 10));
+						tmpBuf = next;
 					}
 
 					currentOps++;
@@ -224,10 +278,135 @@ bool Problem::loadInitialData(const char* filename)
 		}
 	}
 
+	// niekompletny plik (np. z gniazda) - bez zadan, maszyn lub operacji
+	bool complete = numJobs > 0 && numMachines > 0 && currJob == static_cast<int>(numJobs);
+	for(int i = 0; complete && i < currJob; ++i)
+		complete = jobs[i].numOps > 0;
+	if(!complete)
+	{
+		fprintf(stderr, "Error: incomplete problem data.\n");
+		return false;
+	}
+
+	return prepareData();
+}
+// -------------------------------------------------------------------------
+bool Problem::copyInitialData(const Problem& source)
+{
+	clearAllSolutions();
+
+	jobs = source.jobs;
+	numJobs = source.numJobs;
+	numMachines = source.numMachines;
+	geneBytes = source.geneBytes;
+	return prepareData();
+}
+// -------------------------------------------------------------------------
+bool Problem::prepareData()
+{
 	// maksymalna ilosc operacji
+	maxOps = 0;
 	for(uint32 i = 0; i < numJobs; ++i)
 		maxOps = std::max(jobs[i].numOps, maxOps);
 
+	// poczatki wierszy w plaskiej tablicy genow
+	rowOffsets.resize(numJobs + 1);
+	numOps = 0;
+	for(uint32 i = 0; i < numJobs; ++i)
+	{
+		rowOffsets[i] = numOps;
+		numOps += jobs[i].numOps;
+	}
+	rowOffsets[numJobs] = numOps;
+
+	opJob.resize(numOps);
+	for(uint32 i = 0; i < numJobs; ++i)
+		for(uint32 k = rowOffsets[i]; k < rowOffsets[i + 1]; ++k)
+			opJob[k] = i;
+
+	// * Lower bounds
+	// Each job needs at least the sum of its shortest operation times and
+	// the machines together need at least the sum of all shortest times.
+	// (Every operation may run on every machine in this file format, so
+	// no single machine has a bound of its own above the average workload.)
+	opMinCost.resize(numOps);
+	costTable.assign(static_cast<size_t>(numOps) * numMachines, 0);
+	uint64 workload = 0;
+	jobBound = 0;
+	for(uint32 i = 0; i < numJobs; ++i)
+	{
+		uint32 jobLength = 0;
+		for(uint32 k = 0; k < jobs[i].numOps; ++k)
+		{
+			const std::vector<int>& costs = jobs[i].ops[k].costs;
+			uint32* row = &costTable[0] + static_cast<size_t>(rowOffsets[i] + k) * numMachines;
+			for(uint32 m = 0; m < numMachines && m < costs.size(); ++m)
+				row[m] = static_cast<uint32>(costs[m]);
+			uint32 minCost = costs.empty() ? 0
+				: static_cast<uint32>(*std::min_element(costs.begin(), costs.end()));
+			opMinCost[rowOffsets[i] + k] = minCost;
+			jobLength += minCost;
+		}
+		jobBound = std::max(jobBound, jobLength);
+		workload += jobLength;
+	}
+	workloadBound = numMachines ? static_cast<uint32>((workload + numMachines - 1) / numMachines) : 0;
+	lowerBound = std::max(jobBound, workloadBound);
+
+	// numer zadania musi zmiescic sie w sekwencji (2 bajty)
+	if(numJobs > 65536)
+	{
+		fprintf(stderr, "Error: too many jobs (%d).\n", numJobs);
+		return false;
+	}
+
+	// kolejnosc kolumnowa: pierwsze operacje wszystkich zadan, potem drugie itd.
+	defaultSequence.clear();
+	defaultSequence.reserve(numOps);
+	for(uint32 i = 0; i < maxOps; ++i)
+	{
+		for(uint32 j = 0; j < numJobs; ++j)
+		{
+			if(i < jobs[j].numOps)
+				defaultSequence.push_back(static_cast<uint16>(j));
+		}
+	}
+
+	// bufory robocze dekodera dla kazdego watku
+	scratch.resize(omp_get_max_threads());
+	for(size_t t = 0; t < scratch.size(); ++t)
+	{
+		scratch[t].machineTime.resize(numMachines);
+		scratch[t].jobTime.resize(numJobs);
+		scratch[t].gapFirst.resize(numMachines);
+		scratch[t].gapCount.resize(numMachines);
+		// na maszynie jest najwyzej tyle luk ile operacji (+1 na wyrownanie)
+		scratch[t].gaps.resize(numOps + numMachines);
+		scratch[t].nextOp.resize(numJobs);
+		scratch[t].priority.resize(numOps);
+		scratch[t].readyFirst.resize(numMachines);
+		scratch[t].readyCount.resize(numMachines);
+		scratch[t].readyBest.resize(numMachines);
+		scratch[t].ready.resize(numOps);
+		scratch[t].jobMask.resize(numJobs);
+		scratch[t].machineSlack.resize(numMachines);
+		scratch[t].jobSlack.resize(numJobs);
+		scratch[t].times.resize(numOps);
+		scratch[t].decodes = 0;
+		scratch[t].rejected = 0;
+		scratch[t].head.resize(numOps);
+		scratch[t].tail.resize(numOps);
+		scratch[t].order.resize(numOps);
+		scratch[t].machineFirst.resize(numMachines + 1);
+		scratch[t].machineOps.resize(numOps);
+		scratch[t].machinePos.resize(numOps);
+		scratch[t].path.resize(numOps);
+		scratch[t].pathLength = 0;
+		scratch[t].seqPos.resize(numOps);
+		scratch[t].segment.resize(numOps);
+		scratch[t].segmentHead.resize(numOps);
+	}
+
 	// wygeneruj mape kolorow
 	colors.resize(numJobs);
 	for(uint32 i = 0; i < numJobs; ++i)
@@ -237,13 +416,66 @@ bool Problem::loadInitialData(const char* filename)
 		colors[i].b = rnd.randomUnorm();
 	}
 
-	file.close();
 	return true;
 }
 // -------------------------------------------------------------------------
 void Problem::generateRandomSolutions(uint32 populationSize)
 {
+	stopStart = omp_get_wtime();
+
+#if defined(EVO_TRACE)
+	tracer.reset();
+#endif
+
 	rnd.setBound(0, numMachines - 1);
+	allocatePopulations(populationSize);
+
+	for(uint32 i = 0; i < populationSize; ++i)
+	{
+		Genome* newGenome = pop[i];
+
+		for(uint32 k = 0; k < numOps; ++k)
+		{
+			uint32 machine = rnd.random();
+			newGenome->setMachine(k, machine);
+		}
+		buildMachineIndex(*newGenome);
+
+		if(useSequence)
+		{
+			// losowa permutacja kolejnosci kolumnowej (Fisher-Yates)
+			uint16* seq = newGenome->sequence;
+			memcpy(seq, &defaultSequence[0], numOps * sizeof(uint16));
+			for(uint32 k = numOps - 1; k > 0; --k)
+				std::swap(seq[k], seq[rnd.random(0, k)]);
+		}
+
+		computeStartingTime(*newGenome);
+	}
+
+	//printf("size of tmpPop: %d\nsize of pop: %d\n", tmpPop.size(), pop.size());
+
+	sort(pop);
+	calcStats(pop);
+	fitness(pop);
+
+	// inicjalizacja populacji nie wchodzi do statystyk profilera
+	profiler.reset();
+	memset(&lsStats, 0, sizeof(lsStats));
+	for(size_t t = 0; t < scratch.size(); ++t)
+	{
+		scratch[t].decodes = scratch[t].rejected = 0;
+		memset(&scratch[t].screening, 0, sizeof(ScreeningStats));
+	}
+	resetAdaptation();
+	resetStopState();
+}
+// -------------------------------------------------------------------------
+void Problem::allocatePopulations(uint32 populationSize)
+{
+	clearAllSolutions();
+	indexPop = 0;
+	generation = 0;
 
 	size_t tmpPopSize;
 
@@ -255,39 +487,74 @@ void Problem::generateRandomSolutions(uint32 populationSize)
 	tmpPop.reserve(tmpPopSize);
 	pop.reserve(populationSize);
 
+	// jedna alokacja na obie populacje - nie robimy tego w kazdym kroku (defragmentacja)
+	pool.create(populationSize + tmpPopSize, numOps, geneBytes, numMachines, numJobs,
+		&rowOffsets[0], useSequence, hugePages);
+
 	for(uint32 i = 0; i < populationSize; ++i)
-	{
-		Genome* newGenome = new Genome(*this);
+		pop.push_back(pool.get(i));
+	for(uint32 i = 0; i < tmpPopSize; ++i)
+		tmpPop.push_back(pool.get(populationSize + i));
 
-		for(uint32 k = 0; k < numJobs; ++k)
-		{
-			for(uint32 j = 0; j < jobs[k].ops.size(); ++j)
-			{
-				uint32 machine = rnd.random();
-				newGenome->rows[k].genes[j] = Gene(machine, -1);
-			}
-		}
+	// Wartosci (suma prawdopodobienstwa) dla ruletki
+	psum = new float[pop.size()];
+	choices = new uint32[pop.size()];
+}
+// -------------------------------------------------------------------------
+void Problem::buildMachineIndex(Genome& gen)
+{
+	uint32* first = gen.machineStart;
 
-		computeStartingTime(*newGenome);
-		pop.push_back(newGenome);
+	for(uint32 m = 0; m < numMachines; ++m)
+	{
+		gen.load[m] = 0;
+		first[m + 1] = 0;
 	}
+	first[0] = 0;
+	for(uint32 j = 0; j < numJobs; ++j)
+		gen.jobLoad[j] = 0;
 
-	for(uint32 i = 0; i < tmpPopSize; ++i)
+	for(uint32 op = 0; op < numOps; ++op)
 	{
-		// tylko aby zaalokowac pamiec i nie robic tego w kazdym kroku (defragmentacja)
-		Genome* tmpGenome = new Genome(*this);
-		tmpPop.push_back(tmpGenome);
+		uint32 m = gen.machine(op);
+		gen.load[m] += opCost(op, m);
+		gen.jobLoad[opJob[op]] += opCost(op, m);
+		first[m + 1]++;
 	}
+	for(uint32 m = 0; m < numMachines; ++m)
+		first[m + 1] += first[m];
 
-	//printf("size of tmpPop: %d\nsize of pop: %d\n", tmpPop.size(), pop.size());
+	// rozlozenie operacji do segmentow maszyn (first[m] tymczasowo jako kursor)
+	for(uint32 op = 0; op < numOps; ++op)
+	{
+		uint32 pos = first[gen.machine(op)]++;
+		gen.place(pos, op);
+	}
+	for(uint32 m = numMachines; m > 0; --m)
+		first[m] = first[m - 1];
+	first[0] = 0;
+}
+// -------------------------------------------------------------------------
+bool Problem::restoreMachineIndex(Genome& gen, const uint32* ops)
+{
+	// obciazenia i granice segmentow zaleza tylko od genow
+	buildMachineIndex(gen);
 
-	sort(pop);
-	calcStats(pop);
-	fitness(pop);
+	for(uint32 op = 0; op < numOps; ++op)
+		gen.clearSlot(op);
 
-	// Wartosci (suma prawdopodobienstwa) dla ruletki
-	psum = new float[pop.size()];
-	choices = new uint32[pop.size()];
+	for(uint32 m = 0; m < numMachines; ++m)
+	{
+		for(uint32 pos = gen.machineStart[m]; pos < gen.machineStart[m + 1]; ++pos)
+		{
+			uint32 op = ops[pos];
+			// operacja spoza segmentu swojej maszyny lub powtorzona
+			if(op >= numOps || gen.machine(op) != m || gen.slot(op) != numOps)
+				return false;
+			gen.place(pos, op);
+		}
+	}
+	return true;
 }
 // -------------------------------------------------------------------------
 void Problem::showPopulation()
@@ -307,6 +574,102 @@ void Problem::showPopulationStats()
 	printf("Min value of objective function: %d\n", minObjective);
 	printf("Max value of objective function: %d\n", maxObjective);
 	printf("Avg value of objective function: %f\n", average);
+	printf("Lower bound of objective function: %d (gap %.2f%%)\n", lowerBound, 100.0f * optimalityGap());
+}
+// -------------------------------------------------------------------------
+void Problem::showProfile()
+{
+	uint64 sum = 0;
+	for(int p = 0; p < PP_COUNT; ++p)
+		sum += profiler.totalCycles(static_cast<EProfilePhase>(p));
+
+	printf("\n======= Phase breakdown (%d generations): =======\n", profiler.numGenerations());
+	printf("%-10s %12s %14s %12s %7s\n", "phase", "calls", "Mcycles", "cycles/call", "%");
+
+	for(int p = 0; p < PP_COUNT; ++p)
+	{
+		EProfilePhase phase = static_cast<EProfilePhase>(p);
+		uint64 cycles = profiler.totalCycles(phase);
+		uint64 count = profiler.totalCount(phase);
+
+		printf("%-10s %12llu %14.3f %12.0f %6.2f%%\n", Profiler::phaseName(phase),
+			static_cast<unsigned long long>(count), cycles * 1e-6,
+			count ? static_cast<double>(cycles) / count : 0.0,
+			sum ? 100.0 * cycles / sum : 0.0);
+	}
+}
+// -------------------------------------------------------------------------
+bool Problem::setPerfCounters(bool enable)
+{
+	memset(perfGen, 0, sizeof(perfGen));
+	memset(perfTotal, 0, sizeof(perfTotal));
+	perfGenerations = 0;
+
+	if(!enable)
+	{
+		perf.close();
+		return true;
+	}
+	return perf.open();
+}
+// -------------------------------------------------------------------------
+void Problem::showPerfCounters()
+{
+	if(!perf.isAvailable())
+	{
+		printf("Hardware performance counters unavailable.\n");
+		return;
+	}
+
+	printf("\n======= Hardware counters (%d generations): =======\n", perfGenerations);
+	printf("%-10s %14s %14s %6s %9s %9s %9s\n", "phase", "cycles", "instructions",
+		"IPC", "L1d MPKI", "LLC MPKI", "br MPKI");
+
+	for(int p = 0; p < PF_COUNT; ++p)
+	{
+		const uint64* v = perfTotal[p];
+		// misses per kilo instruction
+		double kinstr = v[PE_INSTRUCTIONS] * 1e-3;
+
+		printf("%-10s %14llu %14llu", PerfCounters::phaseName(static_cast<EPerfPhase>(p)),
+			static_cast<unsigned long long>(v[PE_CYCLES]),
+			static_cast<unsigned long long>(v[PE_INSTRUCTIONS]));
+		printf(" %6.2f", v[PE_CYCLES] ? static_cast<double>(v[PE_INSTRUCTIONS]) / v[PE_CYCLES] : 0.0);
+
+		for(int e = PE_L1D_MISSES; e < PE_COUNT; ++e)
+		{
+			if(perf.isAvailable(static_cast<EPerfEvent>(e)) && kinstr > 0.0)
+				printf(" %9.3f", v[e] / kinstr);
+			else
+				printf(" %9s", "n/a");
+		}
+		printf("\n");
+	}
+}
+// -------------------------------------------------------------------------
+void Problem::showScreening()
+{
+	ScreeningStats st = getScreeningStats();
+
+	printf("\n======= Offspring screening (factor %.2f): =======\n", screenFactor);
+	printf("passed %llu (good %llu), screened out %llu (audited %llu, good %llu)\n",
+		static_cast<unsigned long long>(st.passed), static_cast<unsigned long long>(st.passedGood),
+		static_cast<unsigned long long>(st.screenedOut), static_cast<unsigned long long>(st.audited),
+		static_cast<unsigned long long>(st.auditedGood));
+	printf("precision %.2f%%, recall %.2f%%\n", 100.0 * st.precision(), 100.0 * st.recall());
+
+	// Koszt pelnego dekodowania z profilera (tylko z EVO_PROFILE)
+	uint64 calls = profiler.totalCount(PP_DECODE);
+	if(calls > st.skipped())
+	{
+		double perDecode = static_cast<double>(profiler.totalCycles(PP_DECODE)) / (calls - st.skipped());
+		printf("skipped decodes %llu, ~%.3f Mcycles saved\n",
+			static_cast<unsigned long long>(st.skipped()), st.skipped() * perDecode * 1e-6);
+	}
+	else
+	{
+		printf("skipped decodes %llu\n", static_cast<unsigned long long>(st.skipped()));
+	}
 }
 // -------------------------------------------------------------------------
 #if defined(EVO_QT_SUPPORT)
@@ -323,6 +686,103 @@ void Problem::getPopulationDesc(QString& desc)
 	strm << "Max value of objective function: " << maxObjective << "\n";
 	strm << "Avg value of objective function: " << average << "\n";
 	strm << "Std deviation of objective function: " << stdDeviation << "\n";
+	strm << "Lower bound of objective function: " << lowerBound
+		 << " (gap " << 100.0f * optimalityGap() << "%)\n";
+
+	if(fitModel == FM_NSGA2)
+	{
+		uint32 frontSize = 0;
+		for(size_t i = 0; i < popSrc.size(); ++i)
+			frontSize += popSrc[i]->rank == 0;
+		strm << "Pareto front: " << frontSize << " individuals\n";
+	}
+}
+// -------------------------------------------------------------------------
+void Problem::getProfileDesc(QString& desc)
+{
+	QTextStream strm(&desc);
+	strm.setRealNumberNotation(QTextStream::FixedNotation);
+
+	uint64 sum = 0;
+	for(int p = 0; p < PP_COUNT; ++p)
+		sum += profiler.totalCycles(static_cast<EProfilePhase>(p));
+
+	strm << "======= Phase breakdown (" << profiler.numGenerations() << " generations): =======\n";
+	strm << "phase\tcalls\tMcycles\tcycles/call\t%\n";
+
+	for(int p = 0; p < PP_COUNT; ++p)
+	{
+		EProfilePhase phase = static_cast<EProfilePhase>(p);
+		uint64 cycles = profiler.totalCycles(phase);
+		uint64 count = profiler.totalCount(phase);
+
+		strm.setRealNumberPrecision(3);
+		strm << Profiler::phaseName(phase) << "\t" << count << "\t" << cycles * 1e-6 << "\t";
+		strm.setRealNumberPrecision(0);
+		strm << (count ? static_cast<double>(cycles) / count : 0.0) << "\t";
+		strm.setRealNumberPrecision(2);
+		strm << (sum ? 100.0 * cycles / sum : 0.0) << "%\n";
+	}
+}
+// -------------------------------------------------------------------------
+void Problem::getPerfDesc(QString& desc)
+{
+	QTextStream strm(&desc);
+
+	if(!perf.isAvailable())
+	{
+		strm << "Hardware performance counters unavailable.\n";
+		return;
+	}
+
+	strm.setRealNumberNotation(QTextStream::FixedNotation);
+	strm.setRealNumberPrecision(3);
+
+	strm << "======= Hardware counters (" << perfGenerations << " generations): =======\n";
+	strm << "phase\tcycles\tinstructions\tIPC\tL1d MPKI\tLLC MPKI\tbr MPKI\n";
+
+	for(int p = 0; p < PF_COUNT; ++p)
+	{
+		const uint64* v = perfTotal[p];
+		double kinstr = v[PE_INSTRUCTIONS] * 1e-3;
+
+		strm << PerfCounters::phaseName(static_cast<EPerfPhase>(p)) << "\t"
+			 << v[PE_CYCLES] << "\t" << v[PE_INSTRUCTIONS] << "\t"
+			 << (v[PE_CYCLES] ? static_cast<double>(v[PE_INSTRUCTIONS]) / v[PE_CYCLES] : 0.0);
+
+		for(int e = PE_L1D_MISSES; e < PE_COUNT; ++e)
+		{
+			if(perf.isAvailable(static_cast<EPerfEvent>(e)) && kinstr > 0.0)
+				strm << "\t" << v[e] / kinstr;
+			else
+				strm << "\tn/a";
+		}
+		strm << "\n";
+	}
+}
+// -------------------------------------------------------------------------
+void Problem::getScreeningDesc(QString& desc)
+{
+	QTextStream strm(&desc);
+	strm.setRealNumberNotation(QTextStream::FixedNotation);
+	strm.setRealNumberPrecision(2);
+
+	ScreeningStats st = getScreeningStats();
+
+	strm << "======= Offspring screening (factor " << screenFactor << "): =======\n";
+	strm << "passed " << st.passed << " (good " << st.passedGood << "), screened out "
+		 << st.screenedOut << " (audited " << st.audited << ", good " << st.auditedGood << ")\n";
+	strm << "precision " << 100.0 * st.precision() << "%, recall " << 100.0 * st.recall() << "%\n";
+
+	uint64 calls = profiler.totalCount(PP_DECODE);
+	strm << "skipped decodes " << st.skipped();
+	if(calls > st.skipped())
+	{
+		strm.setRealNumberPrecision(3);
+		double perDecode = static_cast<double>(profiler.totalCycles(PP_DECODE)) / (calls - st.skipped());
+		strm << ", ~" << st.skipped() * perDecode * 1e-6 << " Mcycles saved";
+	}
+	strm << "\n";
 }
 #endif
 // -------------------------------------------------------------------------
@@ -331,13 +791,55 @@ bool sortPredicate(Genome* a, Genome* b)
 	return a->objective < b->objective;
 }
 // -------------------------------------------------------------------------
+// Porownanie zatloczenia NSGA-II: nizszy front, potem wieksza odleglosc,
+// potem krotszy makespan (skrajny punkt frontu z najkrotszym makespanem na poczatku)
+bool crowdedPredicate(Genome* a, Genome* b)
+{
+	if(a->rank != b->rank)
+		return a->rank < b->rank;
+	if(a->crowding != b->crowding)
+		return a->crowding > b->crowding;
+	return a->objective < b->objective;
+}
+// -------------------------------------------------------------------------
 void Problem::sort(Population& pop)
 {
-	std::sort(pop.begin(), pop.end(), sortPredicate);
+	EVO_PROFILE_SCOPE(profiler, PP_SORT);
+	EVO_TRACE_SCOPE(tracer, "sort");
+	PerfScope perfScope_(perf, perfGen[PF_SORT]);
+
+	if(fitModel == FM_NSGA2)
+	{
+		pareto.rank(&pop[0], static_cast<uint32>(pop.size()));
+		std::sort(pop.begin(), pop.end(), crowdedPredicate);
+	}
+	else
+	{
+		std::sort(pop.begin(), pop.end(), sortPredicate);
+	}
+}
+// -------------------------------------------------------------------------
+void Problem::survivePareto(Population& survivors, Population& rest)
+{
+	paretoPop.clear();
+	paretoPop.insert(paretoPop.end(), survivors.begin(), survivors.end());
+	paretoPop.insert(paretoPop.end(), rest.begin(), rest.end());
+	sort(paretoPop);
+
+	// same wskazniki - genomy nie sa kopiowane
+	EVO_PROFILE_SCOPE(profiler, PP_REINSERT);
+	EVO_TRACE_SCOPE(tracer, "reinsert");
+	PerfScope perfScope_(perf, perfGen[PF_REINSERT]);
+	std::copy(paretoPop.begin(), paretoPop.begin() + survivors.size(), survivors.begin());
+	std::copy(paretoPop.begin() + survivors.size(), paretoPop.end(), rest.begin());
 }
 // -------------------------------------------------------------------------
 void Problem::fitness(Population& pop)
 {
+	EVO_PROFILE_SCOPE(profiler, PP_FITNESS);
+	EVO_TRACE_SCOPE(tracer, "fitness");
+	PerfScope perfScope_(perf, perfGen[PF_FITNESS]);
+
 	// * Sigma scaling
 	if(fitModel == FM_SIGMASCALING)
 	{
@@ -346,12 +848,14 @@ void Problem::fitness(Population& pop)
 		{
 			// w locie - zamiana minimalizacji na maksymalizacje
 			// (amerykanska literatura)
-			pop[i]->fitness = std::max(static_cast<float>((maxObjective - pop[i]->objective))
+			// (odrzuceni przez dekodowanie z progiem sa gorsi od maxObjective)
+			pop[i]->fitness = pop[i]->objective > maxObjective ? 0.0f
+				: std::max(static_cast<float>((maxObjective - pop[i]->objective))
 				- (averageInv - sp * stdDeviationInv), 0.0f);
 		}
 	}
-	// * Linear ranking
-	else if(fitModel == FM_LINEARRANKING)
+	// * Linear ranking (FM_NSGA2 - populacja jest posortowana porownaniem zatloczenia)
+	else if(fitModel == FM_LINEARRANKING || fitModel == FM_NSGA2)
 	{
 		#pragma omp parallel for
 		for(int32 i = 0; i < static_cast<int32>(pop.size()); ++i)
@@ -369,7 +873,8 @@ void Problem::fitness(Population& pop)
 		for(int32 i = 0; i < static_cast<int32>(pop.size()); ++i)
 		{
 			// map 1:1
-			pop[i]->fitness = static_cast<float>(maxObjective - pop[i]->objective);
+			pop[i]->fitness = pop[i]->objective > maxObjective ? 0.0f
+				: static_cast<float>(maxObjective - pop[i]->objective);
 		}
 	}
 
@@ -391,40 +896,62 @@ void Problem::fitness(Population& pop)
 // -------------------------------------------------------------------------
 void Problem::calcStats(Population& pop)
 {
-	maxObjective = pop[0]->objective;
-	minObjective = pop[0]->objective;
+	EVO_PROFILE_SCOPE(profiler, PP_STATS);
+	EVO_TRACE_SCOPE(tracer, "calcStats");
+	PerfScope perfScope_(perf, perfGen[PF_STATS]);
+
+	// Odrzuceni przez dekodowanie z progiem (PM_SIMPLE zostawia ich w populacji)
+	// maja objective = ograniczenie - statystyki, a z nimi prog nastepnego
+	// pokolenia, licza sie tylko z dokladnie zdekodowanych (o ile jacys sa)
+	bool exactOnly = false;
+	for(uint32 i = 0; i < pop.size() && !exactOnly; ++i)
+		exactOnly = !pop[i]->rejected;
+
+	maxObjective = 0;
+	minObjective = 0xFFFFFFFF;
 	average = 0.0f;
 	averageInv = 0.0f;
+	uint32 count = 0;
 
 	for(uint32 i = 0; i < pop.size(); ++i)
 	{
+		if(exactOnly && pop[i]->rejected)
+			continue;
+
 		uint32 f = pop[i]->objective;
 		minObjective = std::min(f, minObjective);
 		maxObjective = std::max(f, maxObjective);
 		average += f;
+		++count;
 	}
-	average /= pop.size();
+	average /= count;
 
 	for(uint32 i = 0; i < pop.size(); ++i)
 	{
+		if(exactOnly && pop[i]->rejected)
+			continue;
+
 		uint32 f = maxObjective - pop[i]->objective;
 		averageInv += f;
 	}
-	averageInv /= pop.size();
+	averageInv /= count;
 
 	// Odchylenie standardowe
 	stdDeviation = 0.0f;
 	stdDeviationInv = 0.0f;
 	for(uint32 i = 0; i < pop.size(); ++i)
 	{
+		if(exactOnly && pop[i]->rejected)
+			continue;
+
 		float f = static_cast<float>((maxObjective - pop[i]->objective) - averageInv);
 		stdDeviationInv += f * f;
 
 		f = static_cast<float>(pop[i]->objective - average);
 		stdDeviation += f * f;
 	}
-	stdDeviation = sqrtf(stdDeviation / pop.size());
-	stdDeviationInv = sqrtf(stdDeviationInv / pop.size());
+	stdDeviation = sqrtf(stdDeviation / count);
+	stdDeviationInv = sqrtf(stdDeviationInv / count);
 }
 // -------------------------------------------------------------------------
 uint32 Problem::best(Population& pop)
@@ -434,7 +961,10 @@ uint32 Problem::best(Population& pop)
 	for(uint32 i = 0; i < pop.size(); ++i)
 	{
 		if(pop[i]->objective < bestVal)
+		{
 			index = i;
+			bestVal = pop[i]->objective;
+		}
 	}
 	return index;
 }
@@ -446,7 +976,10 @@ uint32 Problem::worst(Population& pop)
 	for(uint32 i = 0; i < pop.size(); ++i)
 	{
 		if(pop[i]->objective > worstVal)
+		{
 			index = i;
+			worstVal = pop[i]->objective;
+		}
 	}
 	return index;
 }
@@ -657,84 +1190,164 @@ Genome& Problem::selectSus(Population& pop)
 // -------------------------------------------------------------------------
 void Problem::create1New(int i, Population& popSrc, Population& popDst)
 {
-	Genome& mom = (this->*(pfnSelect))(popSrc);
-	Genome& dad = (this->*(pfnSelect))(popSrc);
+	Genome* parents[2];
+	{
+		EVO_PROFILE_SCOPE(profiler, PP_SELECT);
+		parents[0] = &(this->*(pfnSelect))(popSrc);
+		parents[1] = &(this->*(pfnSelect))(popSrc);
+	}
+	Genome& mom = *parents[0];
+	Genome& dad = *parents[1];
+
+	// Bez krzyzowania potomek to jeden z rodzicow - kopiujemy go dopiero
+	// na koncu, albo robi to sam operator mutacji (jedna kopia zamiast dwoch)
+	const Genome* kid = popDst[i];
 
 	// Czy krzyzujemy
 	float pcx = rnd.randomUnorm();
 	if(pcx <= probCX)
 	{
-		Genome tmp(*this);
-
-		if(rnd.randomUnorm() > probOperator)
-			rowCrossover(mom, dad, *popDst[i], tmp);
+		EOperator op = rnd.randomUnorm() > probOperator ? OP_ROW_CX : OP_COLUMN_CX;
+		if(op == OP_ROW_CX)
+			rowCrossover(mom, dad, *popDst[i]);
 		else
-			columnCrossover(mom, dad, *popDst[i], tmp);
+			columnCrossover(mom, dad, *popDst[i]);
+
+		if(adaptive)
+			creditOperator(op, std::min(mom.objective, dad.objective), popDst[i]->objective);
 	}
 	else
 	{
 		if(rnd.randomUnorm() > 0.5f)
-			*popDst[i] = dad;
+			kid = &dad;
 		else
-			*popDst[i] = mom;
+			kid = &mom;
 	}
 
 	// Czy mutujemy
 	float pmut = rnd.randomUnorm();
 	if(pmut <= probMUT)
-		mutate(*popDst[i], *popDst[i]);
+	{
+		uint32 before = kid->objective;
+		mutate(*kid, *popDst[i]);
+		if(adaptive)
+			creditOperator(OP_MUTATION, before, popDst[i]->objective);
+	}
+	else if(kid != popDst[i])
+	{
+		EVO_PROFILE_SCOPE(profiler, PP_CROSSOVER);
+		*popDst[i] = *kid;
+	}
 }
 // -------------------------------------------------------------------------
 void Problem::create2New(int i, Population& popSrc, Population& popDst)
 {
-	Genome& mom = (this->*(pfnSelect))(popSrc);
-	Genome& dad = (this->*(pfnSelect))(popSrc);
+	Genome* parents[2];
+	{
+		EVO_PROFILE_SCOPE(profiler, PP_SELECT);
+		parents[0] = &(this->*(pfnSelect))(popSrc);
+		parents[1] = &(this->*(pfnSelect))(popSrc);
+	}
+	Genome& mom = *parents[0];
+	Genome& dad = *parents[1];
+
+	// Zrodla potomkow - po krzyzowaniu sa juz na miejscu w popDst
+	const Genome* kids[2] = { popDst[i], popDst[i+1] };
 
 	// Czy krzyzujemy
 	float pcx = rnd.randomUnorm();
 	if(pcx <= probCX)
 	{
-		if(rnd.randomUnorm() > probOperator)
+		EOperator op = rnd.randomUnorm() > probOperator ? OP_ROW_CX : OP_COLUMN_CX;
+		if(op == OP_ROW_CX)
 			rowCrossover(mom, dad, *popDst[i], *popDst[i+1]);
 		else
 			columnCrossover(mom, dad, *popDst[i], *popDst[i+1]);
+
+		if(adaptive)
+		{
+			uint32 before = std::min(mom.objective, dad.objective);
+			creditOperator(op, before, popDst[i]->objective);
+			creditOperator(op, before, popDst[i+1]->objective);
+		}
 	}
 	else
 	{
-		// przenies rodzicow do nastepnego pokolenia
-		*popDst[i] = mom;
-		*popDst[i+1] = dad;
+		// przenies rodzicow do nastepnego pokolenia (rodzic moze byc wybrany
+		// wielokrotnie, wiec nie da sie go przeniesc bez kopii)
+		kids[0] = &mom;
+		kids[1] = &dad;
 	}
 
-	// Czy mutujemy
-	float pmut = rnd.randomUnorm();
-	if(pmut <= probMUT)
-		mutate(*popDst[i], *popDst[i]);
-	pmut = rnd.randomUnorm();
-	if(pmut <= probMUT)
-		mutate(*popDst[i+1], *popDst[i+1]);
-}
-// -------------------------------------------------------------------------
-void Problem::nextGenSteadyState(Population& popSrc, Population& popDst)
+	// Czy mutujemy - mutacja sama kopiuje rodzica do popDst
+	for(int k = 0; k < 2; ++k)
+	{
+		float pmut = rnd.randomUnorm();
+		if(pmut <= probMUT)
+		{
+			uint32 before = kids[k]->objective;
+			mutate(*kids[k], *popDst[i+k]);
+			if(adaptive)
+				creditOperator(OP_MUTATION, before, popDst[i+k]->objective);
+		}
+		else if(kids[k] != popDst[i+k])
+		{
+			EVO_PROFILE_SCOPE(profiler, PP_CROSSOVER);
+			*popDst[i+k] = *kids[k];
+		}
+	}
+}
+// -------------------------------------------------------------------------
+void Problem::nextGenSteadyState(Population& popSrc, Population& popDst)
 {
 	//assert(popOverlap <= popSrc.size());
 
 	// popSrc sie w wiekszosci nie zmienia
 	// popDst jest to populacja tymczasowa
 
-	for(uint32 i = 0; i < popDst.size() - 1; i += 2)
-		create2New(i, popSrc, popDst);
+	// Potomek nie gorszy od najgorszego z popSrc nie zastapi nikogo
+	// (przy zastepowaniu losowym kazdy trafia do populacji - bez progu)
+	if(maxObjective > 0 && fitModel != FM_NSGA2 &&
+		(popModel == PM_SS_ELITISM || popModel == PM_SS_EXCESS))
+		acceptThreshold = maxObjective - 1;
+	if(boundedDecoding)
+		decodeCutoff = acceptThreshold;
+
+	{
+		PerfScope perfScope_(perf, perfGen[PF_BREED]);
+
+		for(uint32 i = 0; i < popDst.size() - 1; i += 2)
+		{
+			EVO_TRACE_SCOPE(tracer, "offspring");
+			create2New(i, popSrc, popDst);
+		}
+
+		if(popDst.size() % 2 != 0)
+		{
+			EVO_TRACE_SCOPE(tracer, "offspring");
+			create1New(popDst.size() - 1, popSrc, popDst);
+		}
+	}
+
+	decodeCutoff = acceptThreshold = NO_CUTOFF;
+	localSearchTop(popDst);
 
-	if(popDst.size() % 2 != 0)
-		create1New(popDst.size() - 1, popSrc, popDst);
+	// * NSGA-II: (mu + lambda) zamiast modelu zastepowania
+	if(fitModel == FM_NSGA2)
+	{
+		survivePareto(popSrc, popDst);
+	}
 
 	// * 4+3
-	if(popModel == PM_SS_EXCESS)
+	else if(popModel == PM_SS_EXCESS)
 	{
 		sort(popDst);
 
 		replaceCoeff = std::min(std::max(replaceCoeff, 0.0f), 1.0f);
 
+		EVO_PROFILE_SCOPE(profiler, PP_REINSERT);
+		EVO_TRACE_SCOPE(tracer, "reinsert");
+		PerfScope perfScope_(perf, perfGen[PF_REINSERT]);
 		uint32 nReplace = static_cast<uint32>(floorf(replaceCoeff * popSrc.size()));
 		uint32 i = popSrc.size() - nReplace;
 		uint32 j = 0;
@@ -743,7 +1356,9 @@ void Problem::nextGenSteadyState(Population& popSrc, Population& popDst)
 		{
 			if(popSrc[i]->objective > popDst[j]->objective)
 			{
-				*popSrc[i] = *popDst[j];
+				// zamiana wskaznikow zamiast kopiowania genow - zastapiony
+				// osobnik trafia do popDst, ktora i tak zostanie nadpisana
+				std::swap(popSrc[i], popDst[j]);
 				j++;
 			}
 		}
@@ -762,6 +1377,9 @@ void Problem::nextGenSteadyState(Population& popSrc, Population& popDst)
 		// 3* porownujemy 8 z 9, jest lepsze, zastepujemy, i++, j++
 		// koniec po i
 
+		EVO_PROFILE_SCOPE(profiler, PP_REINSERT);
+		EVO_TRACE_SCOPE(tracer, "reinsert");
+		PerfScope perfScope_(perf, perfGen[PF_REINSERT]);
 		uint32 i = popSrc.size() - popDst.size();
 		uint32 j = 0;
 
@@ -769,7 +1387,9 @@ void Problem::nextGenSteadyState(Population& popSrc, Population& popDst)
 		{
 			if(popSrc[i]->objective > popDst[j]->objective)
 			{
-				*popSrc[i] = *popDst[j];
+				// zamiana wskaznikow zamiast kopiowania genow - zastapiony
+				// osobnik trafia do popDst, ktora i tak zostanie nadpisana
+				std::swap(popSrc[i], popDst[j]);
 				j++;
 			}
 		}
@@ -777,6 +1397,9 @@ void Problem::nextGenSteadyState(Population& popSrc, Population& popDst)
 	// * UNIFORM REINSERTION
 	else if(popModel == PM_SS_UNIFORM)
 	{
+		EVO_PROFILE_SCOPE(profiler, PP_REINSERT);
+		EVO_TRACE_SCOPE(tracer, "reinsert");
+		PerfScope perfScope_(perf, perfGen[PF_REINSERT]);
 		std::set<uint32> replaced;
 		for(uint32 j = 0; j < popDst.size(); ++j)
 		{
@@ -787,7 +1410,7 @@ void Problem::nextGenSteadyState(Population& popSrc, Population& popDst)
 			} while(replaced.find(choice) != replaced.end());
 			replaced.insert(choice);
 
-			*popSrc[choice] = *popDst[j];
+			std::swap(popSrc[choice], popDst[j]);
 		}
 	}
 
@@ -797,21 +1420,52 @@ void Problem::nextGenSteadyState(Population& popSrc, Population& popDst)
 	//	printf("%d ", (*it)->objective);
 	//printf("\n\n");
 
-	// Aktualizuj dane dla populacji
-	sort(popSrc);
+	// Aktualizuj dane dla populacji (survivePareto juz posortowal)
+	if(fitModel != FM_NSGA2)
+		sort(popSrc);
 	calcStats(popSrc);
 	fitness(popSrc);
 }
 // -------------------------------------------------------------------------
 void Problem::nextGenSimple(Population& popSrc, Population& popDst)
 {
-	#pragma omp parallel for
-	for(int32 i = 0; i < static_cast<int32>(pop.size() - 1); i += 2)
-		create2New(i, popSrc, popDst);
+	// Potomkowie gorsi od najgorszego z biezacej populacji sa tylko z grubsza
+	// uporzadkowani (objective = ograniczenie) - selekcja i tak rzadko ich wybiera,
+	// a statystyki i prog nastepnego pokolenia licza sie bez nich (calcStats)
+	// w FM_NSGA2 gorszy makespan nie wyklucza potomka (moze byc niezdominowany)
+	if(fitModel != FM_NSGA2)
+		acceptThreshold = maxObjective;
+	if(boundedDecoding)
+		decodeCutoff = acceptThreshold;
+
+	{
+		PerfScope perfScope_(perf, perfGen[PF_BREED]);
+
+		#pragma omp parallel
+		{
+			#pragma omp for nowait
+			for(int32 i = 0; i < static_cast<int32>(pop.size() - 1); i += 2)
+			{
+				EVO_TRACE_SCOPE(tracer, "offspring");
+				create2New(i, popSrc, popDst);
+			}
+
+			// czas oczekiwania watkow na koniec pokolenia (nierowne obciazenie)
+			EVO_TRACE_BEGIN(tracer, "barrier");
+			#pragma omp barrier
+			EVO_TRACE_END(tracer, "barrier");
+		}
+
+		if(popSrc.size() % 2 != 0)
+		{
+			EVO_TRACE_SCOPE(tracer, "offspring");
+			create1New(popSrc.size() - 1, popSrc, popDst);
+		}
+	}
+
+	decodeCutoff = acceptThreshold = NO_CUTOFF;
+	localSearchTop(popDst);
 
-	if(popSrc.size() % 2 != 0)
-		create1New(popSrc.size() - 1, popSrc, popDst);
-	
 	// 1->0->1->0
 	++indexPop;
 	indexPop = indexPop % 2;
@@ -819,16 +1473,29 @@ void Problem::nextGenSimple(Population& popSrc, Population& popDst)
 	// * GENITOR
 	// Przenies najlepszego osobnika ze starej populacji do nowej w zamian za najgorszego
 	// O ile jest taka potrzeba
-	if(genitor)
+	if(genitor && fitModel != FM_NSGA2)
 	{
-		if(popDst[best(popDst)]->objective > popSrc[best(popSrc)]->objective)
+		EVO_PROFILE_SCOPE(profiler, PP_REINSERT);
+		EVO_TRACE_SCOPE(tracer, "genitor");
+		PerfScope perfScope_(perf, perfGen[PF_REINSERT]);
+		uint32 bestSrc = best(popSrc);
+		if(popDst[best(popDst)]->objective > popSrc[bestSrc]->objective)
 		{
-			*popDst[worst(popDst)] = *popSrc[best(popSrc)];
+			// popSrc bedzie nadpisana w nastepnym pokoleniu - wystarczy zamiana wskaznikow
+			std::swap(popDst[worst(popDst)], popSrc[bestSrc]);
 		}
 	}
 
 	// Aktualizuj dane dla populacji
-	sort(popDst);
+	if(fitModel == FM_NSGA2)
+	{
+		// (mu + lambda) - rodzice z popSrc walcza o miejsce z potomkami
+		survivePareto(popDst, popSrc);
+	}
+	else
+	{
+		sort(popDst);
+	}
 	calcStats(popDst);
 	fitness(popDst);
 }
@@ -841,256 +1508,1920 @@ void Problem::nextGen()
 	Population& popSrc = (indexPop ? tmpPop : pop);
 	Population& popDst = (indexPop ? pop : tmpPop);
 
-	if(ssMethod == SS_ROULETTE)
-		preselectRoulette(popSrc);
-	else if(ssMethod == SS_SUS)
-		preselectSus(popSrc);
+	EVO_TRACE_SCOPE(tracer, "generation");
+	memset(perfGen, 0, sizeof(perfGen));
+
+	{
+		EVO_PROFILE_SCOPE(profiler, PP_PRESELECT);
+		EVO_TRACE_SCOPE(tracer, "preselect");
+		PerfScope perfScope_(perf, perfGen[PF_PRESELECT]);
+		if(ssMethod == SS_ROULETTE)
+			preselectRoulette(popSrc);
+		else if(ssMethod == SS_SUS)
+			preselectSus(popSrc);
+	}
 
 	(this->*(pfnNextGen))(popSrc, popDst);
+	++generation;
+
+	if(adaptive)
+		adaptOperators();
+
+	updateBest();
+
+	if(checkpointEvery && generation % checkpointEvery == 0)
+	{
+		// obraz w pamieci, zapis do pliku w tle
+		EVO_TRACE_SCOPE(tracer, "checkpoint");
+		serialize(checkpointData);
+		checkpointWriter.submit(checkpointFile, checkpointData);
+	}
+
+#if defined(EVO_PROFILE)
+	profiler.merge();
+#endif
+
+	if(perf.isAvailable())
+	{
+		for(int p = 0; p < PF_COUNT; ++p)
+			for(int e = 0; e < PE_COUNT; ++e)
+				perfTotal[p][e] += perfGen[p][e];
+		++perfGenerations;
+	}
 }
 // -------------------------------------------------------------------------
-uint32 Problem::objectiveScore(Genome& gen)
+void Problem::resetAdaptation()
 {
-	uint32 max = 0;
-	for(uint32 k = 0; k < numJobs; ++k)
+	// krzyzowanie dzieli sie na dwa operatory wg probOperator
+	adaptBudget = probCX + probMUT;
+	float cx = adaptBudget > 0.0f ? probCX / adaptBudget : 0.0f;
+	opProb[OP_ROW_CX] = cx * (1.0f - probOperator);
+	opProb[OP_COLUMN_CX] = cx * probOperator;
+	opProb[OP_MUTATION] = adaptBudget > 0.0f ? probMUT / adaptBudget : 0.0f;
+	memset(opQuality, 0, sizeof(opQuality));
+
+	for(size_t t = 0; t < scratch.size(); ++t)
 	{
-		int lastOpIdx = gen.rows[k].genes.size()-1;
-		int lastOpsJobIdx = jobs[k].ops.size()-1;
-		int machineIdx = gen.rows[k].genes[lastOpIdx].machine;
-
-		uint32 lastOpStart = gen.rows[k].genes[lastOpIdx].time;
-		uint32 lastOpEnd = lastOpStart + jobs[k].ops[lastOpsJobIdx].costs[machineIdx];
-
-		max = std::max(max, lastOpEnd);
+		memset(scratch[t].opUses, 0, sizeof(scratch[t].opUses));
+		memset(scratch[t].opCredit, 0, sizeof(scratch[t].opCredit));
 	}
-	return max;
 }
 // -------------------------------------------------------------------------
-uint32 Problem::computeStartingTime(Genome& gen)
+void Problem::adaptOperators()
 {
-	// Contains the deadline od the last operation scheduled on machine M[k]
-	uint32* DMk = new uint32[numMachines];
-	// Containst the deadline of the last operation scheduled on Job[j]
-	uint32* Tf = new uint32[numJobs];
-
-	for(uint32 i = 0; i < numMachines; ++i)
-		DMk[i] = 0;
-	for(uint32 i = 0; i < numJobs; ++i)
-		Tf[i] = 0;
-
-	for(uint32 i = 0; i < maxOps; ++i)
+	// * Step 1: jakosc operatora - srednia wykladnicza sredniej nagrody z pokolenia
+	for(uint32 k = 0; k < OP_COUNT; ++k)
 	{
-		for(uint32 j = 0; j < numJobs; ++j)
+		uint32 uses = 0;
+		double credit = 0.0;
+		for(size_t t = 0; t < scratch.size(); ++t)
 		{
-			if(jobs[j].numOps <= i)
-				continue;
+			uses += scratch[t].opUses[k];
+			credit += scratch[t].opCredit[k];
+			scratch[t].opUses[k] = 0;
+			scratch[t].opCredit[k] = 0.0;
+		}
 
-			int machineIdx = gen.rows[j].genes[i].machine;
+		// operator bez uzyc zachowuje jakosc
+		if(uses > 0)
+			opQuality[k] += adaptAlpha * (static_cast<float>(credit / uses) - opQuality[k]);
+		opUses[k] = uses;
+	}
 
-			// calculate
-			{
-				if(Tf[j] < DMk[machineIdx])
-					gen.rows[j].genes[i].time = DMk[machineIdx];
-				else
-					gen.rows[j].genes[i].time = Tf[j];
-			}
-			// update
-			{
-				Tf[j] = gen.rows[j].genes[i].time + jobs[j].ops[i].costs[machineIdx];
-				DMk[machineIdx] = gen.rows[j].genes[i].time + jobs[j].ops[i].costs[machineIdx];
-			}
-		}
+	// * Step 2: pursuit - najlepszy operator w strone maksimum, reszta do minimum.
+	//   Bez zadnej poprawy (zbiezna populacja) prawdopodobienstwa zostaja
+	uint32 bestOp = 0;
+	for(uint32 k = 1; k < OP_COUNT; ++k)
+	{
+		if(opQuality[k] > opQuality[bestOp])
+			bestOp = k;
 	}
 
-	// makespan
-	uint32 makespan = Tf[getMaxIdx(Tf, numJobs)];
+	if(opQuality[bestOp] > 0.0f)
+	{
+		float maxProb = 1.0f - (OP_COUNT - 1) * adaptMinProb;
+		for(uint32 k = 0; k < OP_COUNT; ++k)
+			opProb[k] += adaptBeta * ((k == bestOp ? maxProb : adaptMinProb) - opProb[k]);
+	}
 
-	delete [] DMk;
-	delete [] Tf;
+	// * Step 3: prawdopodobienstwa operatorow -> parametry krzyzowania i mutacji
+	float cx = opProb[OP_ROW_CX] + opProb[OP_COLUMN_CX];
+	if(cx > 0.0f)
+		probOperator = opProb[OP_COLUMN_CX] / cx;
+	probCX = std::min(adaptBudget * cx, 1.0f);
+	probMUT = std::min(adaptBudget * opProb[OP_MUTATION], 1.0f);
 
-	return (gen.objective = makespan);
+	if(operatorLog)
+	{
+		fprintf(operatorLog, "%u %.4f %.4f %.4f %.6f %.6f %.6f %u %u %u\n", generation,
+			probCX, probMUT, probOperator,
+			opQuality[OP_ROW_CX], opQuality[OP_COLUMN_CX], opQuality[OP_MUTATION],
+			opUses[OP_ROW_CX], opUses[OP_COLUMN_CX], opUses[OP_MUTATION]);
+	}
 }
 // -------------------------------------------------------------------------
-void Problem::mutate(const Genome& in, Genome& out)
+void Problem::resetStopState()
 {
-	out = in;
-
-	// Calculate load of the machine before mutation
-	uint32* machineLoad = new uint32[numMachines];
-	for(uint32 i = 0; i < numMachines; ++i)
-		machineLoad[i] = 0;
-
-	for(uint32 i = 0; i < numJobs; ++i)
+	stopReason = SR_NONE;
+	// pierwsze updateBest zapamieta biezacego najlepszego
+	bestObjective = 0xFFFFFFFF;
+	bestGeneration = generation;
+
+	omp_set_lock(&anytimeLock);
+	anytimeFront.resize(0);
+	anytimeFront.makespan = 0;
+	omp_unset_lock(&anytimeLock);
+	anytimePending = false;
+
+	updateBest();
+}
+// -------------------------------------------------------------------------
+void Problem::updateBest()
+{
+	// NOTE: bez GENITOR'a najlepszy w populacji moze sie pogorszyc
+	if(minObjective < bestObjective)
 	{
-		for(uint32 j = 0; j < jobs[i].ops.size(); ++j)
+		bestObjective = minObjective;
+		bestGeneration = generation;
+
+		if(anytime)
 		{
-			const Gene& g = in.rows[i].genes[j];
-			int cost = jobs[i].ops[j].costs[g.machine];
-			machineLoad[g.machine] += cost;
+			// przy FM_NSGA2 populacja nie jest posortowana wg makespanu
+			Population& popSrc = (indexPop ? tmpPop : pop);
+			uint32 best = 0;
+			for(uint32 i = 1; i < popSrc.size(); ++i)
+			{
+				if(popSrc[i]->objective < popSrc[best]->objective)
+					best = i;
+			}
+			getSchedule(*popSrc[best], anytimeBack);
+			anytimePending = true;
 		}
 	}
 
-	uint32 maxMachineLoad = getMaxIdx(machineLoad, numMachines);
-	uint32 minMachineLoad = getMinIdx(machineLoad, numMachines);
-
-	// * Step 1
-	// Choose randomly one genome and one operation
-	// from the set of operations assigned to a machine with a high load.
-
-	std::vector<Gene*> geneSet;
-	for(uint32 i = 0; i < numJobs; ++i)
+	// bufor czytany wlasnie przez inny watek - podmiana w nastepnym pokoleniu
+	if(anytimePending && omp_test_lock(&anytimeLock))
 	{
-		for(uint32 j = 0; j < jobs[i].ops.size(); ++j)
-		{
-			if(in.rows[i].genes[j].machine == maxMachineLoad)
-				geneSet.push_back(&out.rows[i].genes[j]);
-		}
+		anytimeFront.swap(anytimeBack);
+		anytimePending = false;
+		omp_unset_lock(&anytimeLock);
 	}
-
-	uint32 random;
-	if(geneSet.size() > 1)
-		random = rnd.random(0, geneSet.size() - 1);
+}
+// -------------------------------------------------------------------------
+bool Problem::getBestSchedule(ScheduleTable& table)
+{
+	omp_set_lock(&anytimeLock);
+	bool ok = anytimeFront.rows() > 0;
+	if(ok)
+		table = anytimeFront;
+	omp_unset_lock(&anytimeLock);
+	return ok;
+}
+// -------------------------------------------------------------------------
+bool Problem::shouldStop()
+{
+	const StopConditions& sc = stopConditions;
+
+	// od najtanszych - czas i liczba dekodowan na koncu
+	if(reachedLowerBound())
+		stopReason = SR_LOWER_BOUND;
+	else if(sc.target && bestObjective <= sc.target)
+		stopReason = SR_TARGET;
+	else if(sc.maxGenerations && generation >= sc.maxGenerations)
+		stopReason = SR_GENERATIONS;
+	else if(sc.stagnation && getStagnation() >= sc.stagnation)
+		stopReason = SR_STAGNATION;
+	else if(sc.maxEvaluations && getDecodeCount() >= sc.maxEvaluations)
+		stopReason = SR_EVALUATIONS;
+	else if(sc.timeLimit > 0.0 && getElapsedTime() >= sc.timeLimit)
+		stopReason = SR_TIME;
 	else
-		random = 0;
+		stopReason = SR_NONE;
 
-	// * Step 2
-	// Assign this operation to another machine with a small load, if possible
-	Gene* g = geneSet[random];
-	g->machine = minMachineLoad;
+	return stopReason != SR_NONE;
+}
+// -------------------------------------------------------------------------
+Problem::EStopReason Problem::run()
+{
+	while(!shouldStop())
+		nextGen();
+	return stopReason;
+}
+// -------------------------------------------------------------------------
+const char* Problem::stopReasonName(EStopReason reason)
+{
+	static const char* names[] = { "none", "time", "evaluations", "generations",
+		"stagnation", "target", "lowerBound" };
+	return names[reason];
+}
+// -------------------------------------------------------------------------
+bool Problem::setOperatorLog(const char* filename)
+{
+	if(operatorLog)
+	{
+		fclose(operatorLog);
+		operatorLog = 0;
+	}
+	if(!filename)
+		return true;
 
-	computeStartingTime(out);
+	operatorLog = fopen(filename, "w");
+	if(!operatorLog)
+	{
+		fprintf(stderr, "Can't open %s for writing\n", filename);
+		return false;
+	}
 
-	delete [] machineLoad;
+	fprintf(operatorLog, "# generation probCX probMUT probOperator "
+		"quality_row quality_column quality_mut uses_row uses_column uses_mut\n");
+	return true;
 }
 // -------------------------------------------------------------------------
-void Problem::columnCrossover(const Genome& mom, const Genome& dad, 
-	Genome& kid1, Genome& kid2)
+uint32 Problem::objectiveScore(const Genome& gen, const uint32* times)
 {
-	// * Step 1
-	// Choose randomly one operation.
-	rnd.setBound(0, maxOps - 1);
-	uint32 op = rnd.random();
-	
-	// * Step 2
-	// Operation 'op' of all the jobs in C1 (resp. C2) received 
-	// the same machines assigned to Operation 'op' of all the jobs
-	// of P1 (resp. P2).
-	for(uint32 i = 0; i < numJobs; ++i)
+	uint32 max = 0;
+	for(uint32 k = 0; k < numJobs; ++k)
 	{
-		if(jobs[i].ops.size() <= op)
-			continue;
-		kid1.rows[i].genes[op] = mom.rows[i].genes[op];
-		kid2.rows[i].genes[op] = dad.rows[i].genes[op];
+		int lastOpIdx = jobs[k].numOps-1;
+		int lastOpsJobIdx = jobs[k].ops.size()-1;
+		int machineIdx = gen.machine(k, lastOpIdx);
+
+		uint32 lastOpStart = times[rowOffsets[k] + lastOpIdx];
+		uint32 lastOpEnd = lastOpStart + jobs[k].ops[lastOpsJobIdx].costs[machineIdx];
+
+		max = std::max(max, lastOpEnd);
 	}
+	return max;
+}
+// -------------------------------------------------------------------------
+uint32 Problem::computeStartingTime(Genome& gen, uint32* times)
+{
+	EVO_PROFILE_SCOPE(profiler, PP_DECODE);
+	return decodeGenome(gen, times);
+}
+// -------------------------------------------------------------------------
+uint32 Problem::decodeGenome(Genome& gen, uint32* times)
+{
+	// czasy rozpoczecia sa potrzebne w calosci - bez progu
+	uint32 cutoff = times ? static_cast<uint32>(NO_CUTOFF) : decodeCutoff;
+	uint32 threshold = times ? static_cast<uint32>(NO_CUTOFF) : acceptThreshold;
 
-	// * Step 3
-	// Copy the remainder of the machines assigned to other operations of P2 (resp. P1
-	// in the same operations of C1 (resp. C2)
+	ThreadScratch& sc = threadScratch();
 
-	for(uint32 i = 0; i < numJobs; ++i)
+	// Wstepna ocena surogatem - odrzuceni nie sa dekodowani (poza probka audytowa)
+	bool screened = screenFactor > 0.0f && threshold != NO_CUTOFF;
+	if(screened)
 	{
-		for(uint32 j = 0; j < jobs[i].ops.size(); ++j)
+		uint32 surrogate = std::max(gen.load[getMaxIdx(gen.load, numMachines)],
+			gen.jobLoad[getMaxIdx(gen.jobLoad, numJobs)]);
+		if(surrogate * screenFactor > threshold)
 		{
-			if(j == op)
-				continue;
-			kid1.rows[i].genes[j] = dad.rows[i].genes[j];
-			kid2.rows[i].genes[j] = mom.rows[i].genes[j];
+			ScreeningStats& st = sc.screening;
+			st.screenedOut++;
+			if(!screenAuditPeriod || st.screenedOut % screenAuditPeriod != 0)
+			{
+				// gorszy od progu, nawet jesli surogat jest ponizej
+				gen.rejected = true;
+				return setObjectives(gen, std::max(surrogate, threshold + 1));
+			}
+
+			// audyt: pelne dekodowanie bez progu
+			uint32 makespan = decodeBounded(gen, times, NO_CUTOFF);
+			st.audited++;
+			st.auditedGood += makespan <= threshold;
+			return makespan;
 		}
 	}
 
-	computeStartingTime(kid1);
-	computeStartingTime(kid2);
+	uint32 makespan = decodeBounded(gen, times, cutoff);
+	if(screened)
+	{
+		sc.screening.passed++;
+		sc.screening.passedGood += makespan <= threshold;
+	}
+	return makespan;
 }
 // -------------------------------------------------------------------------
-void Problem::rowCrossover(const Genome& mom, const Genome& dad, 
-	Genome& kid1, Genome& kid2)
+uint32 Problem::decodeBounded(Genome& gen, uint32* times, uint32 cutoff)
 {
-	// * Step 1
-	// Choose randomly job
-	rnd.setBound(0, numJobs - 1);
-	uint32 job = rnd.random();
-
-	// * Step 2
-	// The operation of 'job' in C1 (resp. C2) received the same
-	// machines as those assigned to 'job' of P1 (resp. P2)
+	ThreadScratch& sc = threadScratch();
+	sc.decodes++;
 
-	for(uint32 j = 0; j < jobs[job].ops.size(); ++j)
+	// Najbardziej obciazona maszyna i najdluzsze zadanie - ograniczenie bez dekodowania
+	if(cutoff != NO_CUTOFF)
 	{
-		kid1.rows[job].genes[j] = mom.rows[job].genes[j];
-		kid2.rows[job].genes[j] = dad.rows[job].genes[j];
+		uint32 maxLoad = std::max(gen.load[getMaxIdx(gen.load, numMachines)],
+			gen.jobLoad[getMaxIdx(gen.jobLoad, numJobs)]);
+		if(maxLoad > cutoff)
+		{
+			sc.rejected++;
+			gen.rejected = true;
+			return setObjectives(gen, maxLoad);
+		}
 	}
 
-	// * Step 3
-	// Copy the remainder of the machinees assigned to the operation
-	// of the other jobs of P1 (resp. P2) in the same jobs of C2 (resp. C1)
+	uint32 makespan = runDecoder(gen, times, cutoff);
 
-	for(uint32 i = 0; i < numJobs; ++i)
-	{
-		if(i == job)
-			continue;
+	// przerwane lub pelne, ale i tak gorsze od progu
+	gen.rejected = cutoff != NO_CUTOFF && makespan > cutoff;
+	if(gen.rejected)
+		sc.rejected++;
 
-		for(uint32 j = 0; j < jobs[i].ops.size(); ++j)
-		{
+	return setObjectives(gen, makespan);
+}
+// -------------------------------------------------------------------------
+uint32 Problem::runDecoder(const Genome& gen, uint32* times, uint32 cutoff)
+{
+	const uint16* seq = gen.sequence ? gen.sequence : &defaultSequence[0];
 
-			kid1.rows[i].genes[j] = dad.rows[i].genes[j];
-			kid2.rows[i].genes[j] = mom.rows[i].genes[j];
-		}
+	// petla dekodera rozwinieta osobno dla kazdego rozmiaru genu
+	switch(decoder)
+	{
+	case DC_ACTIVE:
+		return gen.geneBytes == 1
+			? decodeActive(gen.genes8, seq, times, gen, cutoff)
+			: decodeActive(gen.genes16, seq, times, gen, cutoff);
+	case DC_GT_ACTIVE:
+	case DC_GT_NONDELAY:
+		return gen.geneBytes == 1
+			? decodeGifflerThompson(gen.genes8, seq, times, decoder == DC_GT_NONDELAY, gen, cutoff)
+			: decodeGifflerThompson(gen.genes16, seq, times, decoder == DC_GT_NONDELAY, gen, cutoff);
+	default:
+		return gen.geneBytes == 1
+			? decode(gen.genes8, seq, times, gen, cutoff)
+			: decode(gen.genes16, seq, times, gen, cutoff);
 	}
-
-	computeStartingTime(kid1);
-	computeStartingTime(kid2);
 }
 // -------------------------------------------------------------------------
-bool Problem::outputToMatlab(const char* filename, uint32 genomeIndex)
+uint32 Problem::setObjectives(Genome& gen, uint32 makespan)
 {
-	assert(genomeIndex < pop.size());
+	uint32 total = 0;
+	uint32 maxLoad = 0;
+	for(uint32 m = 0; m < numMachines; ++m)
+	{
+		total += gen.load[m];
+		maxLoad = std::max(maxLoad, gen.load[m]);
+	}
 
-	// TODO: na razie pierwszy z brzegu
-	Population& popSrc = (indexPop ? tmpPop : pop);
-	Genome& c = *popSrc[genomeIndex];
+	gen.objectives[Genome::OBJ_MAKESPAN] = makespan;
+	gen.objectives[Genome::OBJ_TOTAL_WORKLOAD] = total;
+	gen.objectives[Genome::OBJ_MAX_WORKLOAD] = maxLoad;
+	return (gen.objective = makespan);
+}
+// -------------------------------------------------------------------------
+void Problem::initSlack(const Genome& gen, uint32 cutoff)
+{
+	ThreadScratch& sc = threadScratch();
 
-	return outputToMatlab(filename, c);
+	// bez progu zapas jest na tyle duzy, ze nigdy sie nie wyczerpie
+	const int32 unlimited = 0x3FFFFFFF;
+	for(uint32 m = 0; m < numMachines; ++m)
+	{
+		sc.machineSlack[m] = cutoff == NO_CUTOFF ? unlimited
+			: static_cast<int32>(cutoff) - static_cast<int32>(gen.load[m]);
+	}
+	for(uint32 j = 0; j < numJobs; ++j)
+	{
+		sc.jobSlack[j] = cutoff == NO_CUTOFF ? unlimited
+			: static_cast<int32>(cutoff) - static_cast<int32>(gen.jobLoad[j]);
+	}
 }
 // -------------------------------------------------------------------------
-bool Problem::outputToMatlab(const char *filename, Genome &gen)
+Problem::ScreeningStats Problem::getScreeningStats() const
 {
-	FILE* fp = fopen(filename, "w+");
-	if(!fp)
-		return false;
+	ScreeningStats st;
+	memset(&st, 0, sizeof(st));
+	for(size_t t = 0; t < scratch.size(); ++t)
+	{
+		const ScreeningStats& s = scratch[t].screening;
+		st.passed += s.passed;
+		st.passedGood += s.passedGood;
+		st.screenedOut += s.screenedOut;
+		st.audited += s.audited;
+		st.auditedGood += s.auditedGood;
+	}
+	return st;
+}
+// -------------------------------------------------------------------------
+uint64 Problem::getDecodeCount() const
+{
+	uint64 n = 0;
+	for(size_t t = 0; t < scratch.size(); ++t)
+		n += scratch[t].decodes;
+	return n;
+}
+// -------------------------------------------------------------------------
+uint64 Problem::getRejectedCount() const
+{
+	uint64 n = 0;
+	for(size_t t = 0; t < scratch.size(); ++t)
+		n += scratch[t].rejected;
+	return n;
+}
+// -------------------------------------------------------------------------
+template<typename T>
+uint32 Problem::decode(const T* machines, const uint16* seq, uint32* times,
+	const Genome& gen, uint32 cutoff)
+{
+	ThreadScratch& sc = threadScratch();
+	// Contains the deadline od the last operation scheduled on machine M[k]
+	uint32* DMk = &sc.machineTime[0];
+	// Containst the deadline of the last operation scheduled on Job[j]
+	uint32* Tf = &sc.jobTime[0];
+	// Index of the next operation of Job[j]
+	uint32* next = &sc.nextOp[0];
+	// How much more M[k] may stay idle and Job[j] may wait before the cutoff is exceeded
+	int32* machineSlack = &sc.machineSlack[0];
+	int32* jobSlack = &sc.jobSlack[0];
+	initSlack(gen, cutoff);
 
+	for(uint32 i = 0; i < numMachines; ++i)
+		DMk[i] = 0;
 	for(uint32 i = 0; i < numJobs; ++i)
 	{
-		float r = colors[i].r;
-		float g = colors[i].g;
-		float b = colors[i].b;
+		Tf[i] = 0;
+		next[i] = 0;
+	}
 
-		fprintf(fp, "color = [%f %f %f];\n", r, g, b);
-		//printf("color = [%f %f %f];\n", r, g, b);
+	for(uint32 k = 0; k < numOps; ++k)
+	{
+		uint32 j = seq[k];
+		uint32 i = next[j]++;
+		uint32 op = rowOffsets[j] + i;
+		int machineIdx = machines[op];
+		uint32 time;
 
-		for(uint32 j = 0; j < jobs[i].ops.size(); ++j)
+		// calculate
 		{
-			uint32 machine = gen.rows[i].genes[j].machine;
-			uint32 startTime = gen.rows[i].genes[j].time;
-			uint32 procTime = jobs[i].ops[j].costs[machine];
-
-			fprintf(fp, "T%d%d = struct('StartTime', %d, 'ProcTime', %d,"
-				"'Machine', %d, 'Name', '%d/%d', 'Color', color);\n",
-				i, j, startTime, procTime, machine, i+1, j+1);
+			if(Tf[j] < DMk[machineIdx])
+			{
+				time = DMk[machineIdx];
+				// the job waits for the machine
+				jobSlack[j] -= time - Tf[j];
+				if(jobSlack[j] < 0)
+					return cutoff - jobSlack[j];
+			}
+			else
+			{
+				time = Tf[j];
+				// the machine waits for the job
+				machineSlack[machineIdx] -= time - DMk[machineIdx];
+				if(machineSlack[machineIdx] < 0)
+					return cutoff - machineSlack[machineIdx];
+			}
 		}
-		fprintf(fp, "\n");
+		// update
+		{
+			Tf[j] = time + jobs[j].ops[i].costs[machineIdx];
+			DMk[machineIdx] = time + jobs[j].ops[i].costs[machineIdx];
+		}
+
+		if(times)
+			times[op] = time;
 	}
 
-	fprintf(fp, "\nT=[");
-	for(uint32 i = 0; i < numJobs; ++i)
+	// makespan
+	return Tf[getMaxIdx(Tf, numJobs)];
+}
+// -------------------------------------------------------------------------
+template<typename T>
+uint32 Problem::decodeActive(const T* machines, const uint16* seq, uint32* times,
+	const Genome& gen, uint32 cutoff)
+{
+	ThreadScratch& sc = threadScratch();
+	// Koniec ostatniej operacji na maszynie (za nim maszyna jest wolna)
+	uint32* DMk = &sc.machineTime[0];
+	// Koniec ostatniej operacji zadania
+	uint32* Tf = &sc.jobTime[0];
+	uint32* gapFirst = &sc.gapFirst[0];
+	uint32* gapCount = &sc.gapCount[0];
+	Interval* gaps = &sc.gaps[0];
+	uint32* next = &sc.nextOp[0];
+	int32* jobSlack = &sc.jobSlack[0];
+	initSlack(gen, cutoff);
+
+	// Kazda maszyna dostaje ciagly segment luk wielkosci (liczba operacji + 1)
+	for(uint32 m = 0; m < numMachines; ++m)
+	{
+		DMk[m] = 0;
+		gapCount[m] = 0;
+	}
+	for(uint32 op = 0; op < numOps; ++op)
+		gapCount[machines[op]]++;
+
+	uint32 first = 0;
+	for(uint32 m = 0; m < numMachines; ++m)
+	{
+		gapFirst[m] = first;
+		first += gapCount[m] + 1;
+		gapCount[m] = 0;
+	}
+
+	for(uint32 j = 0; j < numJobs; ++j)
+	{
+		Tf[j] = 0;
+		next[j] = 0;
+	}
+
+	for(uint32 s = 0; s < numOps; ++s)
 	{
-		for(uint32 j = 0; j < jobs[i].ops.size(); ++j)
+		uint32 j = seq[s];
+		uint32 i = next[j]++;
+		uint32 op = rowOffsets[j] + i;
+		uint32 m = machines[op];
+		uint32 cost = jobs[j].ops[i].costs[m];
+		uint32 ready = Tf[j];
+		uint32 time;
+
+		// Pierwsza luka (w kolejnosci czasu) w ktorej zmiesci sie operacja
+		Interval* g = gaps + gapFirst[m];
+		uint32 n = gapCount[m];
+		uint32 k = 0;
+		for(; k < n; ++k)
 		{
-			fprintf(fp, " T%d%d", i, j);
+			if(std::max(g[k].begin, ready) + cost <= g[k].end)
+				break;
 		}
-	}
 
-	fprintf(fp, " ];\nplotgantt(T, %d);\n", numMachines);
-	fclose(fp);
+		if(k < n)
+		{
+			time = std::max(g[k].begin, ready);
+			Interval left = { g[k].begin, time };
+			Interval right = { time + cost, g[k].end };
+
+			// luka zostaje zastapiona przez 0, 1 lub 2 mniejsze
+			uint32 replace = (left.end > left.begin ? 1 : 0) + (right.end > right.begin ? 1 : 0);
+			if(replace != 1)
+			{
+				memmove(g + k + replace, g + k + 1, (n - k - 1) * sizeof(Interval));
+				gapCount[m] = n - 1 + replace;
+			}
+
+			if(left.end > left.begin)
+				g[k++] = left;
+			if(right.end > right.begin)
+				g[k] = right;
+		}
+		else
+		{
+			// na koncu maszyny - ewentualny przestoj staje sie nowa luka
+			time = std::max(ready, DMk[m]);
+			if(time > DMk[m])
+			{
+				Interval idle = { DMk[m], time };
+				g[gapCount[m]++] = idle;
+			}
+			DMk[m] = time + cost;
+		}
+
+		Tf[j] = time + cost;
+
+		if(times)
+			times[op] = time;
+
+		// Tylko ograniczenie zadania - pozostale operacje maszyny moga
+		// jeszcze trafic do luk przed DMk[m]
+		if(time > ready)
+		{
+			jobSlack[j] -= time - ready;
+			if(jobSlack[j] < 0)
+				return cutoff - jobSlack[j];
+		}
+	}
+
+	// makespan
+	return Tf[getMaxIdx(Tf, numJobs)];
+}
+// -------------------------------------------------------------------------
+template<typename T>
+uint32 Problem::decodeGifflerThompson(const T* machines, const uint16* seq,
+	uint32* times, bool nonDelay, const Genome& gen, uint32 cutoff)
+{
+	ThreadScratch& sc = threadScratch();
+	uint32* DMk = &sc.machineTime[0];
+	uint32* Tf = &sc.jobTime[0];
+	uint32* next = &sc.nextOp[0];
+	uint32* priority = &sc.priority[0];
+	uint32* readyFirst = &sc.readyFirst[0];
+	uint32* readyCount = &sc.readyCount[0];
+	uint32* readyBest = &sc.readyBest[0];
+	ReadyOp* ready = &sc.ready[0];
+	int32* machineSlack = &sc.machineSlack[0];
+	int32* jobSlack = &sc.jobSlack[0];
+	const uint32* costs = &costTable[0];
+	initSlack(gen, cutoff);
+
+	// priorytet operacji = pozycja jej wystapienia w sekwencji
+	for(uint32 j = 0; j < numJobs; ++j)
+	{
+		Tf[j] = 0;
+		next[j] = 0;
+	}
+	for(uint32 k = 0; k < numOps; ++k)
+	{
+		uint32 j = seq[k];
+		priority[rowOffsets[j] + next[j]++] = k;
+	}
+
+	// Na maszynie czeka naraz najwyzej tyle operacji ile ma ich przydzielonych,
+	// wiec kazda maszyna dostaje ciagly segment tej wielkosci
+	for(uint32 m = 0; m < numMachines; ++m)
+		readyCount[m] = 0;
+	for(uint32 op = 0; op < numOps; ++op)
+		readyCount[machines[op]]++;
+
+	uint32 first = 0;
+	for(uint32 m = 0; m < numMachines; ++m)
+	{
+		readyFirst[m] = first;
+		first += readyCount[m];
+		readyCount[m] = 0;
+		readyBest[m] = 0xFFFFFFFF;
+		DMk[m] = 0;
+	}
+
+	// pierwsze operacje zadan sa gotowe od razu
+	for(uint32 j = 0; j < numJobs; ++j)
+	{
+		next[j] = 0;
+		if(jobs[j].numOps == 0)
+			continue;
+
+		uint32 op = rowOffsets[j];
+		uint32 m = machines[op];
+		ReadyOp r = { 0, costs[op * numMachines + m], priority[op], j };
+		ready[readyFirst[m] + readyCount[m]++] = r;
+		readyBest[m] = std::min(readyBest[m], nonDelay ? 0 : r.cost);
+	}
+
+	for(uint32 step = 0; step < numOps; ++step)
+	{
+		// * Step 1
+		// Among the schedulable operations (next operation of every job) find
+		// the earliest completion (active) or the earliest start (non-delay).
+		// Every machine keeps the best time of the operations waiting for it.
+		uint64 bestKey = ~static_cast<uint64>(0);
+		for(uint32 k = 0; k < numMachines; ++k)
+			bestKey = std::min(bestKey, (static_cast<uint64>(readyBest[k]) << 32) | k);
+		uint32 m = static_cast<uint32>(bestKey);
+		uint32 bestTime = static_cast<uint32>(bestKey >> 32);
+
+		// * Step 2
+		// Conflict set: operations on that machine that could start before
+		// that time (active) or start exactly then (non-delay). Pick the one
+		// that comes first in the sequence. The operation found in Step 1
+		// always belongs to the set - with a zero cost it ends at its start.
+		// (klucz = priorytet i indeks, minimum bez skokow warunkowych)
+		ReadyOp* r = ready + readyFirst[m];
+		uint32 n = readyCount[m];
+		uint64 chosenKey = ~static_cast<uint64>(0);
+		for(uint32 k = 0; k < n; ++k)
+		{
+			uint32 start = std::max(r[k].ready, DMk[m]);
+			bool conflict = nonDelay ? start == bestTime
+				: (start < bestTime) | (start + r[k].cost == bestTime);
+			uint64 key = (static_cast<uint64>(r[k].priority) << 32) | k;
+			chosenKey = std::min(chosenKey, conflict ? key : ~static_cast<uint64>(0));
+		}
+		uint32 chosen = static_cast<uint32>(chosenKey);
+
+		// * Step 3
+		// Schedule it as early as possible
+		uint32 j = r[chosen].job;
+		uint32 op = rowOffsets[j] + next[j]++;
+		uint32 time = std::max(Tf[j], DMk[m]);
+
+		// operacje sa zawsze dokladane na koniec maszyny - jak w decode()
+		if(time > Tf[j])
+		{
+			jobSlack[j] -= time - Tf[j];
+			if(jobSlack[j] < 0)
+				return cutoff - jobSlack[j];
+		}
+		else if(time > DMk[m])
+		{
+			machineSlack[m] -= time - DMk[m];
+			if(machineSlack[m] < 0)
+				return cutoff - machineSlack[m];
+		}
+
+		Tf[j] = time + r[chosen].cost;
+		DMk[m] = Tf[j];
+
+		if(times)
+			times[op] = time;
+
+		// * Step 4
+		// Nastepna operacja zadania staje sie gotowa na swojej maszynie. Zmienil
+		// sie tylko koniec maszyny m, wiec inne maszyny zachowuja swoje minima
+		// (dochodzi co najwyzej nowa operacja), a minimum m liczone jest od nowa.
+		r[chosen] = r[--readyCount[m]];
+		if(next[j] < jobs[j].numOps)
+		{
+			uint32 nextOp = op + 1;
+			uint32 nm = machines[nextOp];
+			ReadyOp added = { Tf[j], costs[nextOp * numMachines + nm], priority[nextOp], j };
+			ready[readyFirst[nm] + readyCount[nm]++] = added;
+
+			uint32 start = std::max(added.ready, DMk[nm]);
+			readyBest[nm] = std::min(readyBest[nm], nonDelay ? start : start + added.cost);
+		}
+
+		uint32 best = 0xFFFFFFFF;
+		n = readyCount[m];
+		for(uint32 k = 0; k < n; ++k)
+		{
+			uint32 start = std::max(r[k].ready, DMk[m]);
+			best = std::min(best, nonDelay ? start : start + r[k].cost);
+		}
+		readyBest[m] = best;
+	}
+
+	// makespan
+	return Tf[getMaxIdx(Tf, numJobs)];
+}
+// -------------------------------------------------------------------------
+uint32 Problem::criticalPath(Genome& gen)
+{
+	ThreadScratch& sc = threadScratch();
+	uint32* head = &sc.head[0];
+	uint32* tail = &sc.tail[0];
+	uint32* order = &sc.order[0];
+	uint32* first = &sc.machineFirst[0];
+	uint32* machineOps = &sc.machineOps[0];
+	uint32* machinePos = &sc.machinePos[0];
+	uint32* cursor = &sc.machineTime[0];
+	uint32* path = &sc.path[0];
+
+	// Glowa operacji to jej czas rozpoczecia - dekoder zawsze dosuwa operacje
+	// do konca poprzednika w zadaniu albo na maszynie, wiec jest to zarazem
+	// najdluzsza droga od poczatku harmonogramu
+	uint32 makespan = decodeGenome(gen, head);
+
+	// operacje w kolejnosci rozpoczecia (porzadek topologiczny harmonogramu)
+	for(uint32 op = 0; op < numOps; ++op)
+		order[op] = op;
+	std::sort(order, order + numOps, StartTimeLess(head));
+
+	// kolejnosc operacji na kazdej z maszyn
+	for(uint32 m = 0; m <= numMachines; ++m)
+		first[m] = 0;
+	for(uint32 op = 0; op < numOps; ++op)
+		first[gen.machine(op) + 1]++;
+	for(uint32 m = 0; m < numMachines; ++m)
+	{
+		first[m + 1] += first[m];
+		cursor[m] = first[m];
+	}
+	for(uint32 k = 0; k < numOps; ++k)
+	{
+		uint32 op = order[k];
+		uint32 pos = cursor[gen.machine(op)]++;
+		machineOps[pos] = op;
+		machinePos[op] = pos;
+	}
+
+	// Ogon - najdluzsza droga od konca operacji do konca harmonogramu
+	for(uint32 k = numOps; k-- > 0; )
+	{
+		uint32 op = order[k];
+		uint32 q = 0;
+
+		if(op + 1 < rowOffsets[opJob[op] + 1])
+			q = opCost(op + 1, gen.machine(op + 1)) + tail[op + 1];
+
+		uint32 pos = machinePos[op];
+		if(pos + 1 < first[gen.machine(op) + 1])
+		{
+			uint32 ms = machineOps[pos + 1];
+			q = std::max(q, opCost(ms, gen.machine(ms)) + tail[ms]);
+		}
+		tail[op] = q;
+	}
+
+	// Sciezka krytyczna: od operacji rozpoczynajacej sie w chwili 0 przez kolejne
+	// operacje z head + p + tail == makespan (nastepnik na maszynie ma pierwszenstwo,
+	// dzieki temu bloki sa mozliwie dlugie)
+	sc.pathLength = 0;
+	uint32 op = numOps;
+	for(uint32 k = 0; k < numOps && head[order[k]] == 0; ++k)
+	{
+		uint32 o = order[k];
+		if(opCost(o, gen.machine(o)) + tail[o] == makespan)
+		{
+			op = o;
+			break;
+		}
+	}
+
+	while(op < numOps)
+	{
+		path[sc.pathLength++] = op;
+
+		uint32 end = head[op] + opCost(op, gen.machine(op));
+		uint32 next = numOps;
+
+		uint32 pos = machinePos[op];
+		if(pos + 1 < first[gen.machine(op) + 1])
+		{
+			uint32 ms = machineOps[pos + 1];
+			if(head[ms] == end && end + opCost(ms, gen.machine(ms)) + tail[ms] == makespan)
+				next = ms;
+		}
+		if(next == numOps && op + 1 < rowOffsets[opJob[op] + 1])
+		{
+			uint32 js = op + 1;
+			if(head[js] == end && end + opCost(js, gen.machine(js)) + tail[js] == makespan)
+				next = js;
+		}
+		op = next;
+	}
+
+	return makespan;
+}
+// -------------------------------------------------------------------------
+uint32 Problem::estimateSegment(const Genome& gen, const uint32* seg, uint32 n,
+	uint32 mpEnd, uint32 ms)
+{
+	// Glowy i ogony operacji spoza bloku zostaja jak w obecnym harmonogramie,
+	// w bloku liczone sa na nowo w nowej kolejnosci (Balas, Vazacopoulos)
+	ThreadScratch& sc = threadScratch();
+	const uint32* head = &sc.head[0];
+	const uint32* tail = &sc.tail[0];
+	uint32* heads = &sc.segmentHead[0];
+
+	uint32 prevEnd = mpEnd;
+	for(uint32 k = 0; k < n; ++k)
+	{
+		uint32 op = seg[k];
+		uint32 jpEnd = 0;
+		if(op > rowOffsets[opJob[op]])
+			jpEnd = head[op - 1] + opCost(op - 1, gen.machine(op - 1));
+
+		heads[k] = std::max(jpEnd, prevEnd);
+		prevEnd = heads[k] + opCost(op, gen.machine(op));
+	}
+
+	uint32 estimate = 0;
+	uint32 nextTail = ms < numOps ? opCost(ms, gen.machine(ms)) + tail[ms] : 0;
+	for(uint32 k = n; k-- > 0; )
+	{
+		uint32 op = seg[k];
+		uint32 jsTail = 0;
+		if(op + 1 < rowOffsets[opJob[op] + 1])
+			jsTail = opCost(op + 1, gen.machine(op + 1)) + tail[op + 1];
+
+		uint32 q = std::max(jsTail, nextTail);
+		uint32 p = opCost(op, gen.machine(op));
+		estimate = std::max(estimate, heads[k] + p + q);
+		nextTail = p + q;
+	}
+	return estimate;
+}
+// -------------------------------------------------------------------------
+bool Problem::applyLocalMove(Genome& gen, const LocalMove& mv, bool undo)
+{
+	if(mv.kind == LM_REASSIGN)
+	{
+		reassign(gen, mv.op, undo ? mv.origin : mv.target);
+		return true;
+	}
+
+	// Przeniesienie w sekwencji: 'op' staje tuz przed (LM_FRONT) lub tuz za (LM_BACK)
+	// operacja 'target'. Cofniecie to przeniesienie odwrotne.
+	const uint32* seqPos = &threadScratch().seqPos[0];
+	uint16* seq = gen.sequence;
+	uint32 from = seqPos[mv.op];
+	uint32 to = seqPos[mv.target];
+
+	if(undo)
+	{
+		moveInSequence(seq, to, from);
+		return true;
+	}
+
+	if(mv.kind == LM_FRONT ? (to > from) : (to < from))
+		return false;
+
+	// k-te wystapienie zadania to jego k-ta operacja - nie mozna przeskoczyc
+	// innej operacji tego samego zadania
+	uint32 lo = std::min(from, to);
+	uint32 hi = std::max(from, to);
+	for(uint32 k = lo; k <= hi; ++k)
+	{
+		if(k != from && seq[k] == seq[from])
+			return false;
+	}
+
+	moveInSequence(seq, from, to);
+	return true;
+}
+// -------------------------------------------------------------------------
+bool Problem::localSearch(Genome& gen, uint64& evaluations, uint64& moves)
+{
+	ThreadScratch& sc = threadScratch();
+	uint32 initial = gen.objective;
+	uint32 current = initial;
+
+	for(uint32 it = 0; it < lsMaxIterations; ++it)
+	{
+		current = criticalPath(gen);
+		++evaluations;
+
+		const uint32* head = &sc.head[0];
+		const uint32* tail = &sc.tail[0];
+		const uint32* first = &sc.machineFirst[0];
+		const uint32* machineOps = &sc.machineOps[0];
+		const uint32* machinePos = &sc.machinePos[0];
+		const uint32* path = &sc.path[0];
+		uint32 pathLength = sc.pathLength;
+		uint32* seg = &sc.segment[0];
+
+		sc.moves.clear();
+
+		// * Reassignment
+		// Move a critical operation to another machine. Its place there follows
+		// the start times; the estimate is the longest path through it.
+		for(uint32 k = 0; k < pathLength; ++k)
+		{
+			uint32 op = path[k];
+			uint32 m = gen.machine(op);
+
+			uint32 jpEnd = 0;
+			if(op > rowOffsets[opJob[op]])
+				jpEnd = head[op - 1] + opCost(op - 1, gen.machine(op - 1));
+			uint32 jsTail = 0;
+			if(op + 1 < rowOffsets[opJob[op] + 1])
+				jsTail = opCost(op + 1, gen.machine(op + 1)) + tail[op + 1];
+
+			for(uint32 m2 = 0; m2 < numMachines; ++m2)
+			{
+				if(m2 == m)
+					continue;
+
+				// pierwsza operacja na m2 rozpoczynajaca sie pozniej niz 'op'
+				uint32 lo = first[m2];
+				uint32 hi = first[m2 + 1];
+				while(lo < hi)
+				{
+					uint32 mid = lo + (hi - lo) / 2;
+					if(head[machineOps[mid]] <= head[op])
+						lo = mid + 1;
+					else
+						hi = mid;
+				}
+
+				uint32 mpEnd = 0;
+				if(lo > first[m2])
+				{
+					uint32 mp = machineOps[lo - 1];
+					mpEnd = head[mp] + opCost(mp, m2);
+				}
+				uint32 msTail = 0;
+				if(lo < first[m2 + 1])
+				{
+					uint32 ms = machineOps[lo];
+					msTail = opCost(ms, m2) + tail[ms];
+				}
+
+				LocalMove mv;
+				mv.estimate = std::max(jpEnd, mpEnd) + opCost(op, m2) + std::max(jsTail, msTail);
+				mv.op = op;
+				mv.target = m2;
+				mv.origin = m;
+				mv.kind = LM_REASSIGN;
+				if(mv.estimate < current)
+					sc.moves.push_back(mv);
+			}
+		}
+
+		// * N5/N7
+		// Critical block = maximal run of path operations processed one after
+		// another on the same machine. Move an inner operation to the front or
+		// to the back of its block (with two operations: swap the pair).
+		// Only possible when the genome carries the operation sequence.
+		if(gen.sequence)
+		{
+			uint32* seqPos = &sc.seqPos[0];
+			uint32* next = &sc.nextOp[0];
+			for(uint32 j = 0; j < numJobs; ++j)
+				next[j] = 0;
+			for(uint32 k = 0; k < numOps; ++k)
+			{
+				uint32 j = gen.sequence[k];
+				seqPos[rowOffsets[j] + next[j]++] = k;
+			}
+
+			for(uint32 s = 0; s < pathLength; )
+			{
+				uint32 m = gen.machine(path[s]);
+				uint32 e = s + 1;
+				while(e < pathLength && machinePos[path[e]] == machinePos[path[e - 1]] + 1)
+					++e;
+
+				const uint32* b = path + s;
+				uint32 n = e - s;
+				s = e;
+				if(n < 2)
+					continue;
+
+				for(uint32 i = 1; i < n; ++i)
+				{
+					// b[i] na poczatek bloku: zmienia sie fragment b[0..i]
+					uint32 pos = machinePos[b[0]];
+					uint32 mpEnd = 0;
+					if(pos > first[m])
+						mpEnd = head[machineOps[pos - 1]] + opCost(machineOps[pos - 1], m);
+					uint32 msPos = machinePos[b[i]] + 1;
+					uint32 ms = msPos < first[m + 1] ? machineOps[msPos] : numOps;
+
+					seg[0] = b[i];
+					for(uint32 k = 0; k < i; ++k)
+						seg[k + 1] = b[k];
+
+					LocalMove mv;
+					mv.estimate = estimateSegment(gen, seg, i + 1, mpEnd, ms);
+					mv.op = b[i];
+					mv.target = b[0];
+					mv.origin = m;
+					mv.kind = LM_FRONT;
+					if(mv.estimate < current)
+						sc.moves.push_back(mv);
+				}
+
+				for(uint32 i = 0; i + 1 < n; ++i)
+				{
+					// b[i] na koniec bloku: zmienia sie fragment b[i..n-1]
+					uint32 pos = machinePos[b[i]];
+					uint32 mpEnd = 0;
+					if(pos > first[m])
+						mpEnd = head[machineOps[pos - 1]] + opCost(machineOps[pos - 1], m);
+					uint32 msPos = machinePos[b[n - 1]] + 1;
+					uint32 ms = msPos < first[m + 1] ? machineOps[msPos] : numOps;
+
+					for(uint32 k = i + 1; k < n; ++k)
+						seg[k - i - 1] = b[k];
+					seg[n - i - 1] = b[i];
+
+					LocalMove mv;
+					mv.estimate = estimateSegment(gen, seg, n - i, mpEnd, ms);
+					mv.op = b[i];
+					mv.target = b[n - 1];
+					mv.origin = m;
+					mv.kind = LM_BACK;
+					if(mv.estimate < current)
+						sc.moves.push_back(mv);
+				}
+			}
+		}
+
+		if(sc.moves.empty())
+			break;
+
+		// Najlepiej oszacowane ruchy sprawdzane dekoderem - pierwszy poprawiajacy
+		// jest przyjmowany, a gdy takiego nie ma, pierwszy nie pogarszajacy
+		// (zwykle usuwa jedna z kilku rownoleglych sciezek krytycznych)
+		std::sort(sc.moves.begin(), sc.moves.end());
+		uint32 candidates = std::min(static_cast<uint32>(LS_CANDIDATES),
+			static_cast<uint32>(sc.moves.size()));
+		uint32 chosen = candidates;
+		uint32 sideways = candidates;
+		uint32 chosenValue = current;
+
+		for(uint32 c = 0; c < candidates; ++c)
+		{
+			if(!applyLocalMove(gen, sc.moves[c], false))
+				continue;
+			uint32 value = decodeGenome(gen);
+			++evaluations;
+			applyLocalMove(gen, sc.moves[c], true);
+
+			if(value < current)
+			{
+				chosen = c;
+				chosenValue = value;
+				break;
+			}
+			if(value == current && sideways == candidates)
+				sideways = c;
+		}
+
+		if(chosen == candidates)
+			chosen = sideways;
+		if(chosen == candidates)
+			break;
+
+		applyLocalMove(gen, sc.moves[chosen], false);
+		current = chosenValue;
+		++moves;
+	}
+
+	// ostatni dekodowany wariant mogl zostac wycofany - cele od nowa
+	setObjectives(gen, current);
+	return current < initial;
+}
+// -------------------------------------------------------------------------
+void Problem::localSearchTop(Population& pop)
+{
+	if(lsTopK == 0 || lsMaxIterations == 0)
+		return;
+
+	PerfScope perfScope_(perf, perfGen[PF_LOCALSEARCH]);
+	double start = omp_get_wtime();
+
+	int32 k = static_cast<int32>(std::min(lsTopK, static_cast<uint32>(pop.size())));
+	{
+		EVO_PROFILE_SCOPE(profiler, PP_LOCALSEARCH);
+		std::partial_sort(pop.begin(), pop.begin() + k, pop.end(), sortPredicate);
+	}
+
+	uint32 improved = 0;
+	uint64 evaluations = 0;
+	uint64 moves = 0;
+
+	#pragma omp parallel for schedule(dynamic) reduction(+:improved, evaluations, moves)
+	for(int32 i = 0; i < k; ++i)
+	{
+		EVO_PROFILE_SCOPE(profiler, PP_LOCALSEARCH);
+		EVO_TRACE_SCOPE(tracer, "localSearch");
+		if(localSearch(*pop[i], evaluations, moves))
+			++improved;
+	}
+
+	lsStats.calls += k;
+	lsStats.improved += improved;
+	lsStats.evaluations += evaluations;
+	lsStats.moves += moves;
+	lsStats.seconds += omp_get_wtime() - start;
+}
+// -------------------------------------------------------------------------
+void Problem::mutate(const Genome& in, Genome& out)
+{
+	{
+		EVO_PROFILE_SCOPE(profiler, PP_MUTATE);
+		if(&out != &in)
+			out = in;
+
+		// Obciazenia maszyn i ich operacje sa w indeksie genomu - bez przegladania genow
+		uint32 maxMachineLoad = getMaxIdx(out.load, numMachines);
+		uint32 minMachineLoad = getMinIdx(out.load, numMachines);
+
+		// * Step 1
+		// Choose randomly one genome and one operation
+		// from the set of operations assigned to a machine with a high load.
+		uint32 count = out.machineCount(maxMachineLoad);
+
+		uint32 random;
+		if(count > 1)
+			random = rnd.random(0, count - 1);
+		else
+			random = 0;
+
+		// * Step 2
+		// Assign this operation to another machine with a small load, if possible
+		if(count > 0)
+			reassign(out, out.machineOp(out.machineStart[maxMachineLoad] + random), minMachineLoad);
+
+		// Zmiana kolejnosci operacji (gdy chromosom ja zawiera)
+		if(useSequence)
+			mutateSequence(out);
+	}
+
+	computeStartingTime(out);
+}
+// -------------------------------------------------------------------------
+void Problem::columnCrossover(const Genome& mom, const Genome& dad, 
+	Genome& kid1, Genome& kid2)
+{
+	{
+		EVO_PROFILE_SCOPE(profiler, PP_CROSSOVER);
+
+		// * Step 1
+		// Choose randomly one operation.
+		rnd.setBound(0, maxOps - 1);
+		uint32 op = rnd.random();
+
+		columnCrossoverFill(mom, dad, kid1, op);
+		columnCrossoverFill(dad, mom, kid2, op);
+
+		if(useSequence)
+		{
+			uint8* mask = &threadScratch().jobMask[0];
+			drawJobMask(mask);
+			sequenceCrossoverFill(mom, dad, kid1, mask, true);
+			sequenceCrossoverFill(dad, mom, kid2, mask, false);
+		}
+	}
+
+	computeStartingTime(kid1);
+	computeStartingTime(kid2);
+}
+// -------------------------------------------------------------------------
+void Problem::columnCrossover(const Genome& mom, const Genome& dad, Genome& kid)
+{
+	{
+		EVO_PROFILE_SCOPE(profiler, PP_CROSSOVER);
+
+		rnd.setBound(0, maxOps - 1);
+		uint32 op = rnd.random();
+
+		columnCrossoverFill(mom, dad, kid, op);
+
+		if(useSequence)
+		{
+			uint8* mask = &threadScratch().jobMask[0];
+			drawJobMask(mask);
+			sequenceCrossoverFill(mom, dad, kid, mask, true);
+		}
+	}
+
+	computeStartingTime(kid);
+}
+// -------------------------------------------------------------------------
+void Problem::columnCrossoverFill(const Genome& a, const Genome& b, Genome& kid, uint32 op)
+{
+	// * Step 3
+	// Copy the remainder of the machines assigned to other operations of P2 (resp. P1
+	// in the same operations of C1 (resp. C2)
+	kid.copyMachines(b);
+
+	// * Step 2
+	// Operation 'op' of all the jobs in C1 (resp. C2) received 
+	// the same machines assigned to Operation 'op' of all the jobs
+	// of P1 (resp. P2).
+	for(uint32 i = 0; i < numJobs; ++i)
+	{
+		if(jobs[i].numOps <= op)
+			continue;
+		reassign(kid, rowOffsets[i] + op, a.machine(i, op));
+	}
+}
+// -------------------------------------------------------------------------
+void Problem::rowCrossover(const Genome& mom, const Genome& dad, 
+	Genome& kid1, Genome& kid2)
+{
+	{
+		EVO_PROFILE_SCOPE(profiler, PP_CROSSOVER);
+
+		// * Step 1
+		// Choose randomly job
+		rnd.setBound(0, numJobs - 1);
+		uint32 job = rnd.random();
+
+		rowCrossoverFill(mom, dad, kid1, job);
+		rowCrossoverFill(dad, mom, kid2, job);
+
+		if(useSequence)
+		{
+			uint8* mask = &threadScratch().jobMask[0];
+			drawJobMask(mask);
+			sequenceCrossoverFill(mom, dad, kid1, mask, true);
+			sequenceCrossoverFill(dad, mom, kid2, mask, false);
+		}
+	}
+
+	computeStartingTime(kid1);
+	computeStartingTime(kid2);
+}
+// -------------------------------------------------------------------------
+void Problem::rowCrossover(const Genome& mom, const Genome& dad, Genome& kid)
+{
+	{
+		EVO_PROFILE_SCOPE(profiler, PP_CROSSOVER);
+
+		rnd.setBound(0, numJobs - 1);
+		uint32 job = rnd.random();
+
+		rowCrossoverFill(mom, dad, kid, job);
+
+		if(useSequence)
+		{
+			uint8* mask = &threadScratch().jobMask[0];
+			drawJobMask(mask);
+			sequenceCrossoverFill(mom, dad, kid, mask, true);
+		}
+	}
+
+	computeStartingTime(kid);
+}
+// -------------------------------------------------------------------------
+void Problem::rowCrossoverFill(const Genome& a, const Genome& b, Genome& kid, uint32 job)
+{
+	// * Step 3
+	// Copy the remainder of the machinees assigned to the operation
+	// of the other jobs of P1 (resp. P2) in the same jobs of C2 (resp. C1)
+	kid.copyMachines(b);
+
+	// * Step 2
+	// The operation of 'job' in C1 (resp. C2) received the same
+	// machines as those assigned to 'job' of P1 (resp. P2)
+	for(uint32 k = rowOffsets[job]; k < rowOffsets[job + 1]; ++k)
+		reassign(kid, k, a.machine(k));
+}
+// -------------------------------------------------------------------------
+void Problem::drawJobMask(uint8* mask)
+{
+	// kazde zadanie z prawdopodobienstwem 1/2, ale zaden ze zbiorow nie moze byc pusty
+	uint32 selected = 0;
+	for(uint32 j = 0; j < numJobs; ++j)
+	{
+		mask[j] = rnd.randomUnorm() < 0.5f ? 1 : 0;
+		selected += mask[j];
+	}
+
+	if(numJobs > 1 && (selected == 0 || selected == numJobs))
+	{
+		uint32 j = rnd.random(0, numJobs - 1);
+		mask[j] = !mask[j];
+	}
+}
+// -------------------------------------------------------------------------
+void Problem::sequenceCrossoverFill(const Genome& a, const Genome& b, Genome& kid,
+	const uint8* mask, bool maskValue)
+{
+	// * POX (precedence preserving operation crossover, rowniez JOX)
+	// Operations of the jobs from the selected set keep their positions
+	// from the first parent. The remaining positions are filled with the
+	// operations of the other jobs in the order they appear in the second parent.
+	const uint16* sa = a.sequence;
+	const uint16* sb = b.sequence;
+	uint16* sk = kid.sequence;
+
+	uint32 k = 0;
+	for(uint32 pos = 0; pos < numOps; ++pos)
+	{
+		if((mask[sa[pos]] != 0) == maskValue)
+		{
+			sk[pos] = sa[pos];
+			continue;
+		}
+
+		while((mask[sb[k]] != 0) == maskValue)
+			++k;
+		sk[pos] = sb[k++];
+	}
+}
+// -------------------------------------------------------------------------
+void Problem::mutateSequence(Genome& gen)
+{
+	if(numOps < 2)
+		return;
+
+	uint16* seq = gen.sequence;
+	uint32 from = rnd.random(0, numOps - 1);
+	uint32 to = rnd.random(0, numOps - 1);
+
+	if(rnd.randomUnorm() < 0.5f)
+	{
+		// * Swap
+		// Exchange the operations at two random positions
+		std::swap(seq[from], seq[to]);
+	}
+	else
+	{
+		// * Insert
+		// Move the operation from one position to another, shifting those in between
+		moveInSequence(seq, from, to);
+	}
+}
+// -------------------------------------------------------------------------
+bool Problem::outputToMatlab(const char* filename, uint32 genomeIndex)
+{
+	assert(genomeIndex < pop.size());
+
+	// TODO: na razie pierwszy z brzegu
+	Population& popSrc = (indexPop ? tmpPop : pop);
+	Genome& c = *popSrc[genomeIndex];
+
+	return outputToMatlab(filename, c);
+}
+// -------------------------------------------------------------------------
+bool Problem::outputToMatlab(const char *filename, const Genome &gen)
+{
+	FILE* fp = fopen(filename, "w+");
+	if(!fp)
+		return false;
+
+	ScheduleTable table;
+	getSchedule(gen, table);
+
+	// Macierz wierszy harmonogramu i kolory zadan, struktury dla plotgantt
+	// tworzone po stronie Matlab'a (nazwy T%d%d kolidowaly od 10 zadan/operacji)
+	fprintf(fp, "%% job op machine start proc\nS = [\n");
+	for(size_t i = 0; i < table.rows(); ++i)
+	{
+		fprintf(fp, "%u %u %u %u %u\n", table.job[i] + 1, table.op[i] + 1,
+			table.machine[i], table.start[i], table.end[i] - table.start[i]);
+	}
+
+	fprintf(fp, "];\ncolors = [\n");
+	for(uint32 i = 0; i < numJobs; ++i)
+		fprintf(fp, "%f %f %f\n", colors[i].r, colors[i].g, colors[i].b);
+
+	fprintf(fp, "];\nT = struct('StartTime', num2cell(S(:,4))', 'ProcTime', num2cell(S(:,5))', ...\n"
+		"\t'Machine', num2cell(S(:,3))', ...\n"
+		"\t'Name', arrayfun(@(j, o) sprintf('%%d/%%d', j, o), S(:,1), S(:,2), 'UniformOutput', false)', ...\n"
+		"\t'Color', num2cell(colors(S(:,1),:), 2)');\n");
+	fprintf(fp, "plotgantt(T, %d);\n", numMachines);
+	fclose(fp);
+	return true;
+}
+// -------------------------------------------------------------------------
+void Problem::getSchedule(const Genome& gen, ScheduleTable& table)
+{
+	table.resize(numOps);
+
+	// czasy rozpoczecia nie sa trzymane w genomie - policz je tylko na potrzeby
+	// eksportu, bez progu i bez zapisu celow do genomu
+	uint32* times = &threadScratch().times[0];
+	table.makespan = runDecoder(gen, times, NO_CUTOFF);
+
+	for(uint32 i = 0; i < numJobs; ++i)
+	{
+		for(uint32 j = 0; j < jobs[i].numOps; ++j)
+		{
+			uint32 k = rowOffsets[i] + j;
+			uint32 machine = gen.machine(k);
+			table.job[k] = i;
+			table.op[k] = j;
+			table.machine[k] = machine;
+			table.start[k] = times[k];
+			table.end[k] = times[k] + jobs[i].ops[j].costs[machine];
+		}
+	}
+}
+// -------------------------------------------------------------------------
+void Problem::getSchedule(uint32 genomeIndex, ScheduleTable& table)
+{
+	Population& popSrc = (indexPop ? tmpPop : pop);
+	assert(genomeIndex < popSrc.size());
+	getSchedule(*popSrc[genomeIndex], table);
+}
+// -------------------------------------------------------------------------
+bool Problem::outputSchedule(const char* filename, ScheduleWriter::EFormat format, uint32 topK)
+{
+	Population& popSrc = (indexPop ? tmpPop : pop);
+	if(popSrc.empty())
+		return false;
+
+	ScheduleWriter writer;
+	if(!writer.open(filename, format, numJobs, numMachines))
+		return false;
+
+	// jedna tabela na caly zapis - kolejne harmonogramy nie alokuja pamieci
+	ScheduleTable table;
+	uint32 count = std::min(topK, static_cast<uint32>(popSrc.size()));
+	for(uint32 i = 0; i < count; ++i)
+	{
+		getSchedule(*popSrc[i], table);
+		writer.write(table);
+	}
+	return writer.close();
+}
+// -------------------------------------------------------------------------
+bool lexicographicPredicate(Genome* a, Genome* b)
+{
+	return std::lexicographical_compare(a->objectives, a->objectives + Genome::NUM_OBJECTIVES,
+		b->objectives, b->objectives + Genome::NUM_OBJECTIVES);
+}
+// -------------------------------------------------------------------------
+bool Problem::outputPareto(const char* filename)
+{
+	Population& popSrc = (indexPop ? tmpPop : pop);
+	if(popSrc.empty())
+		return false;
+
+	FILE* fp = fopen(filename, "w");
+	if(!fp)
+	{
+		fprintf(stderr, "Can't open %s for writing\n", filename);
+		return false;
+	}
+
+	// fronty od nowa - poza FM_NSGA2 rank nie jest liczony
+	pareto.rank(&popSrc[0], static_cast<uint32>(popSrc.size()));
+
+	Population front;
+	for(size_t i = 0; i < popSrc.size(); ++i)
+	{
+		if(popSrc[i]->rank == 0)
+			front.push_back(popSrc[i]);
+	}
+	std::sort(front.begin(), front.end(), lexicographicPredicate);
+
+	fprintf(fp, "# makespan total_workload max_workload | machines (jobs row by row)%s\n",
+		useSequence ? " | sequence" : "");
+	for(size_t i = 0; i < front.size(); ++i)
+	{
+		const Genome& gen = *front[i];
+		if(i > 0 && memcmp(gen.objectives, front[i - 1]->objectives, sizeof(gen.objectives)) == 0)
+			continue;
+
+		fprintf(fp, "%u %u %u |", gen.objectives[Genome::OBJ_MAKESPAN],
+			gen.objectives[Genome::OBJ_TOTAL_WORKLOAD], gen.objectives[Genome::OBJ_MAX_WORKLOAD]);
+		for(uint32 op = 0; op < numOps; ++op)
+			fprintf(fp, " %u", gen.machine(op));
+		if(gen.sequence)
+		{
+			fprintf(fp, " |");
+			for(uint32 k = 0; k < numOps; ++k)
+				fprintf(fp, " %u", gen.sequence[k]);
+		}
+		fprintf(fp, "\n");
+	}
+
+	fclose(fp);
+	return true;
+}
+// -------------------------------------------------------------------------
+namespace
+{
+	const char CHECKPOINT_MAGIC[8] = { 'E', 'V', 'O', 'C', 'K', 'P', 'T', 0 };
+	const uint32 CHECKPOINT_VERSION = 2;
+
+	// Licznik jednego watku (ThreadScratch) w obrazie stanu
+	struct ThreadCounters
+	{
+		uint64 decodes;
+		uint64 rejected;
+		uint64 screening[5];
+	};
+}
+// -------------------------------------------------------------------------
+uint64 Problem::problemHash() const
+{
+	uint64 hash = fnv1a(&rowOffsets[0], rowOffsets.size() * sizeof(uint32));
+	for(uint32 j = 0; j < numJobs; ++j)
+	{
+		for(size_t i = 0; i < jobs[j].ops.size(); ++i)
+		{
+			const std::vector<int>& costs = jobs[j].ops[i].costs;
+			hash = fnv1a(&costs[0], costs.size() * sizeof(int), hash);
+		}
+	}
+	return hash;
+}
+// -------------------------------------------------------------------------
+void Problem::setCheckpoint(const char* filename, uint32 every)
+{
+	checkpointFile = filename ? filename : "";
+	checkpointEvery = filename ? every : 0;
+}
+// -------------------------------------------------------------------------
+bool Problem::saveCheckpoint(const char* filename)
+{
+	checkpointWriter.flush();
+
+	std::vector<char> data;
+	serialize(data);
+	return writeFileAtomic(filename, data);
+}
+// -------------------------------------------------------------------------
+bool Problem::loadCheckpoint(const char* filename)
+{
+	std::vector<char> data;
+	if(!readFile(filename, data))
+		return false;
+
+	if(!deserialize(data))
+	{
+		fprintf(stderr, "Error: \"%s\" is not a valid checkpoint for this problem\n", filename);
+		return false;
+	}
+
+	stopStart = omp_get_wtime();
+	resetStopState();
+	return true;
+}
+// -------------------------------------------------------------------------
+void Problem::serialize(std::vector<char>& data)
+{
+	data.clear();
+	BinaryWriter out(data);
+
+	// * Naglowek i identyfikacja problemu
+	out.put(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+	out.put(CHECKPOINT_VERSION);
+	out.put(numJobs);
+	out.put(numMachines);
+	out.put(numOps);
+	out.put(geneBytes);
+	out.put(problemHash());
+
+	// * Ustawienia
+	out.put(static_cast<uint32>(ssMethod));
+	out.put(static_cast<uint32>(popModel));
+	out.put(static_cast<uint32>(fitModel));
+	out.put(static_cast<uint32>(decoder));
+	uint8 flags[5] = { useSequence, genitor, boundedDecoding, pickUnused, hugePages };
+	out.put(flags, 5);
+	out.put(sp);
+	out.put(probCX);
+	out.put(probMUT);
+	out.put(probOperator);
+	out.put(replaceCoeff);
+	out.put(tempPopSize);
+	out.put(tourGroupSize);
+	out.put(screenFactor);
+	out.put(screenAuditPeriod);
+	out.put(lsTopK);
+	out.put(lsMaxIterations);
+	out.put(static_cast<uint8>(adaptive));
+	out.put(adaptAlpha);
+	out.put(adaptBeta);
+	out.put(adaptMinProb);
+	out.put(adaptBudget);
+	out.put(opQuality, OP_COUNT);
+	out.put(opProb, OP_COUNT);
+
+	// * Przebieg i statystyki
+	out.put(generation);
+	out.put(static_cast<int32>(indexPop));
+	out.put(average);
+	out.put(averageInv);
+	out.put(stdDeviation);
+	out.put(stdDeviationInv);
+	out.put(maxObjective);
+	out.put(minObjective);
+	out.put(averageFitness);
+	out.put(maxFitness);
+	out.put(minFitness);
+
+	out.put(lsStats.calls);
+	out.put(lsStats.improved);
+	out.put(lsStats.evaluations);
+	out.put(lsStats.moves);
+	out.put(lsStats.seconds);
+
+	// liczniki watkow - audyt wstepnej oceny zalezy od licznika odrzuconych
+	out.put(static_cast<uint32>(scratch.size()));
+	for(size_t t = 0; t < scratch.size(); ++t)
+	{
+		const ScreeningStats& s = scratch[t].screening;
+		ThreadCounters c = { scratch[t].decodes, scratch[t].rejected,
+			{ s.passed, s.passedGood, s.screenedOut, s.audited, s.auditedGood } };
+		out.put(c);
+	}
+
+	// * Generator liczb losowych
+	std::vector<uint32> rndState;
+	rnd.getState(rndState);
+	out.put(static_cast<uint32>(rndState.size()));
+	out.put(&rndState[0], rndState.size());
+
+	// * Populacje (w obecnej kolejnosci - ta zalezy od sortowania)
+	out.put(static_cast<uint32>(pop.size()));
+	out.put(static_cast<uint32>(tmpPop.size()));
+
+	std::vector<uint32> ops(numOps);
+	for(size_t i = 0; i < pop.size() + tmpPop.size(); ++i)
+	{
+		const Genome& gen = i < pop.size() ? *pop[i] : *tmpPop[i - pop.size()];
+
+		out.put(gen.objective);
+		out.put(gen.fitness);
+		out.put(static_cast<uint8>(gen.rejected));
+		out.put(gen.objectives, Genome::NUM_OBJECTIVES);
+		out.put(gen.rank);
+		out.put(gen.crowding);
+		out.put(gen.genes8, numOps * geneBytes);
+
+		// kolejnosc w segmentach maszyn (reszta indeksu wynika z genow),
+		// w pliku zawsze uint32 niezaleznie od szerokosci w genomie
+		for(uint32 k = 0; k < numOps; ++k)
+			ops[k] = gen.machineOp(k);
+		out.put(&ops[0], numOps);
+
+		if(useSequence)
+			out.put(gen.sequence, numOps);
+	}
+
+	// * Suma kontrolna calosci
+	out.put(fnv1a(&data[0], data.size()));
+}
+// -------------------------------------------------------------------------
+bool Problem::deserialize(const std::vector<char>& data)
+{
+	if(data.size() < sizeof(CHECKPOINT_MAGIC) + sizeof(uint64))
+		return false;
+
+	size_t payload = data.size() - sizeof(uint64);
+	uint64 checksum;
+	memcpy(&checksum, &data[payload], sizeof(checksum));
+	if(checksum != fnv1a(&data[0], payload))
+		return false;
+
+	BinaryReader in(&data[0], payload);
+
+	char magic[sizeof(CHECKPOINT_MAGIC)];
+	uint32 version, jobsCount, machinesCount, opsCount, bytesPerGene;
+	uint64 hash;
+	in.get(magic, sizeof(magic));
+	in.get(version);
+	in.get(jobsCount);
+	in.get(machinesCount);
+	in.get(opsCount);
+	in.get(bytesPerGene);
+	if(!in.get(hash))
+		return false;
+
+	if(memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 || version != CHECKPOINT_VERSION ||
+		jobsCount != numJobs || machinesCount != numMachines || opsCount != numOps ||
+		bytesPerGene != geneBytes || hash != problemHash())
+		return false;
+
+	// * Ustawienia - wczytywane do zmiennych lokalnych, stosowane dopiero gdy
+	//   caly obraz jest poprawny
+	uint32 ss, pm, fm, dc;
+	uint8 flags[5];
+	in.get(ss);
+	in.get(pm);
+	in.get(fm);
+	in.get(dc);
+	in.get(flags, 5);
+
+	float pressure, pCX, pMUT, pOperator, replace, screen;
+	uint32 tempSize, groupSize, auditPeriod, topK, maxIterations;
+	in.get(pressure);
+	in.get(pCX);
+	in.get(pMUT);
+	in.get(pOperator);
+	in.get(replace);
+	in.get(tempSize);
+	in.get(groupSize);
+	in.get(screen);
+	in.get(auditPeriod);
+	in.get(topK);
+	in.get(maxIterations);
+
+	uint8 adapt;
+	float alpha, beta, minProb, budget, quality[OP_COUNT], prob[OP_COUNT];
+	in.get(adapt);
+	in.get(alpha);
+	in.get(beta);
+	in.get(minProb);
+	in.get(budget);
+	in.get(quality, OP_COUNT);
+	in.get(prob, OP_COUNT);
+
+	uint32 gen;
+	int32 index = -1;
+	in.get(gen);
+	in.get(index);
+
+	float stats[9];
+	in.get(stats[0]);
+	in.get(stats[1]);
+	in.get(stats[2]);
+	in.get(stats[3]);
+	uint32 maxObj, minObj;
+	in.get(maxObj);
+	in.get(minObj);
+	in.get(stats[4]);
+	in.get(stats[5]);
+	in.get(stats[6]);
+
+	LocalSearchStats ls;
+	in.get(ls.calls);
+	in.get(ls.improved);
+	in.get(ls.evaluations);
+	in.get(ls.moves);
+	in.get(ls.seconds);
+
+	uint32 numCounters;
+	if(!in.get(numCounters) || numCounters > in.remaining() / sizeof(ThreadCounters))
+		return false;
+	std::vector<ThreadCounters> counters(numCounters);
+	if(numCounters > 0)
+		in.get(&counters[0], numCounters);
+
+	uint32 rndSize;
+	if(!in.get(rndSize) || rndSize > in.remaining() / sizeof(uint32))
+		return false;
+	std::vector<uint32> rndState(rndSize);
+	if(rndSize > 0)
+		in.get(&rndState[0], rndSize);
+
+	uint32 popSize, tmpPopSize;
+	in.get(popSize);
+	if(!in.get(tmpPopSize))
+		return false;
+
+	// rozmiar populacji musi zgadzac sie z reszta obrazu
+	size_t genomeBytes = sizeof(uint32) + sizeof(float) + sizeof(uint8) +
+		Genome::NUM_OBJECTIVES * sizeof(uint32) + sizeof(uint32) + sizeof(float) +
+		numOps * geneBytes + numOps * sizeof(uint32) + (flags[0] ? numOps * sizeof(uint16) : 0);
+	if(ss > SS_RANKING || pm > PM_SS_EXCESS || fm > FM_NSGA2 || dc > DC_GT_NONDELAY ||
+		popSize == 0 || index < 0 || index > 1 ||
+		static_cast<uint64>(popSize + tmpPopSize) * genomeBytes != in.remaining())
+		return false;
+
+	core::Random restored;
+	if(!restored.setState(rndState))
+		return false;
+
+	// * Obraz jest poprawny - ustawienia
+	setSelectMethod(static_cast<ESelectionScheme>(ss));
+	setPopulationModel(static_cast<EPopulationModel>(pm));
+	fitModel = static_cast<EFitnessModel>(fm);
+	decoder = static_cast<EDecoder>(dc);
+	useSequence = flags[0] != 0;
+	genitor = flags[1] != 0;
+	boundedDecoding = flags[2] != 0;
+	pickUnused = flags[3] != 0;
+	hugePages = flags[4] != 0;
+	sp = pressure;
+	probCX = pCX;
+	probMUT = pMUT;
+	probOperator = pOperator;
+	replaceCoeff = replace;
+	tempPopSize = tempSize;
+	tourGroupSize = groupSize;
+	screenFactor = screen;
+	screenAuditPeriod = auditPeriod;
+	lsTopK = topK;
+	lsMaxIterations = maxIterations;
+	setAdaptiveOperators(adapt != 0, alpha, beta, minProb);
+
+	// PM_SIMPLE - tymczasowa populacja ma rozmiar populacji
+	allocatePopulations(popSize);
+	if(tmpPop.size() != tmpPopSize)
+	{
+		clearAllSolutions();
+		return false;
+	}
+
+	std::vector<uint32> ops(numOps);
+	for(size_t i = 0; i < pop.size() + tmpPop.size(); ++i)
+	{
+		Genome& g = i < pop.size() ? *pop[i] : *tmpPop[i - pop.size()];
+
+		uint8 rejected;
+		in.get(g.objective);
+		in.get(g.fitness);
+		in.get(rejected);
+		in.get(g.objectives, Genome::NUM_OBJECTIVES);
+		in.get(g.rank);
+		in.get(g.crowding);
+		in.get(g.genes8, numOps * geneBytes);
+		in.get(&ops[0], numOps);
+		if(useSequence)
+			in.get(g.sequence, numOps);
+		g.rejected = rejected != 0;
+
+		bool valid = true;
+		for(uint32 op = 0; op < numOps && valid; ++op)
+			valid = g.machine(op) < numMachines;
+		if(!valid || !restoreMachineIndex(g, &ops[0]))
+		{
+			clearAllSolutions();
+			return false;
+		}
+	}
+
+	// * Przebieg i statystyki
+	generation = gen;
+	indexPop = index;
+	average = stats[0];
+	averageInv = stats[1];
+	stdDeviation = stats[2];
+	stdDeviationInv = stats[3];
+	maxObjective = maxObj;
+	minObjective = minObj;
+	averageFitness = stats[4];
+	maxFitness = stats[5];
+	minFitness = stats[6];
+	lsStats = ls;
+
+	for(size_t t = 0; t < scratch.size(); ++t)
+	{
+		ThreadCounters c;
+		memset(&c, 0, sizeof(c));
+		if(t < counters.size())
+			c = counters[t];
+
+		scratch[t].decodes = c.decodes;
+		scratch[t].rejected = c.rejected;
+		ScreeningStats& s = scratch[t].screening;
+		s.passed = c.screening[0];
+		s.passedGood = c.screening[1];
+		s.screenedOut = c.screening[2];
+		s.audited = c.screening[3];
+		s.auditedGood = c.screening[4];
+	}
+
+	rnd.setState(rndState);
+
+	// przebieg adaptacji zaczyna sie od nowa, stan operatorow jak w obrazie
+	resetAdaptation();
+	adaptBudget = budget;
+	memcpy(opQuality, quality, sizeof(opQuality));
+	memcpy(opProb, prob, sizeof(opProb));
+
+#if defined(EVO_TRACE)
+	tracer.reset();
+#endif
+	profiler.reset();
 	return true;
 }
 // -------------------------------------------------------------------------
@@ -1,36 +1,254 @@
 #include <omp.h>
 
 #include "core/Random.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "PerfCounters.h"
+#include "GenomePool.h"
+#include "Pareto.h"
+#include "Checkpoint.h"
+#include "ScheduleExport.h"
 
-// * Gen: Dla kazdej operacji przypada jeden taki opisujacy na ktorej maszynie
-//        operacja zostanie wykonana i w jakim czasie zostanie rozpoczeta
-struct Gene
+class Problem;
+
+// * Jedno z rozwiazan. Pamiec na geny pochodzi z GenomePool,
+//   genom sam niczego nie alokuje i nie da sie go skopiowac konstruktorem.
+//
+// * Gen: Dla kazdej operacji przypada jeden, opisujacy na ktorej maszynie
+//        operacja zostanie wykonana. Zajmuje 1 lub 2 bajty (w zaleznosci od liczby
+//        maszyn, wybierane przy wczytywaniu problemu). Czasy rozpoczecia nie sa
+//        przechowywane - dekoder liczy je tylko gdy sa potrzebne (np. przy eksporcie).
+//
+// * Indeks maszyn: obciazenie kazdej maszyny oraz operacje pogrupowane wg maszyn
+//        (machineOps[machineStart[m] .. machineStart[m+1]) to operacje maszyny m,
+//        opSlot - pozycja operacji w machineOps), a takze laczny czas operacji
+//        kazdego zadania. Utrzymywany przyrostowo przez Problem::reassign,
+//        dzieki temu mutacja nie przeglada calego genomu. Indeksy operacji
+//        (machineOps, opSlot) zajmuja 2 bajty, a 4 dopiero od 65536 operacji.
+//
+// * Sekwencja (opcjonalna, Problem::setSequenceChromosome): permutacja z powtorzeniami
+//        numerow zadan, k-te wystapienie zadania j oznacza jego k-ta operacje.
+//        Okresla kolejnosc (priorytet) operacji dla dekodera.
+//
+//   Uklad pamieci: [geny][indeks maszyn][sekwencja] - geny z indeksem to ciagly
+//   blok machineBytes, kopiowany przez krzyzowanie jednym memcpy.
+struct Genome
 {
-	core::uint32 machine;
-	core::uint32 time;
+	Genome(void* genes, core::uint32 numGenes, core::uint32 geneBytes, core::uint32 numMachines,
+		core::uint32 numJobs, const core::uint32* rowOffsets, bool withSequence)
+		: genes8(static_cast<core::uint8*>(genes)), sequence(0), numGenes(numGenes),
+		geneBytes(geneBytes), numMachines(numMachines),
+		machineBytes(indexOffset(numGenes, geneBytes) + indexBytes(numGenes, numMachines, numJobs)),
+		blockBytes(machineBytes), rowOffsets(rowOffsets),
+		objective(0xFFFFFFFF), fitness(0.0f), rejected(false), rank(0), crowding(0.0f)
+	{
+		for(core::uint32 k = 0; k < NUM_OBJECTIVES; ++k)
+			objectives[k] = 0xFFFFFFFF;
 
-	Gene() {}
-	Gene(core::uint32 machine, core::uint32 time)
-		: machine(machine), time(time){}
-};
+		load = reinterpret_cast<core::uint32*>(genes8 + indexOffset(numGenes, geneBytes));
+		machineStart = load + numMachines;
+		jobLoad = machineStart + numMachines + 1;
+		machineOps16 = reinterpret_cast<core::uint16*>(jobLoad + numJobs);
+		wideIndex = numGenes > 0xFFFF;
+		if(wideIndex)
+			opSlot32 = machineOps32 + numGenes;
+		else
+			opSlot16 = machineOps16 + numGenes;
 
-// * Zbior genow (wiersz) koduje rozwiazanie dla jednego zadania
-struct JobGene
-{
-	std::vector<Gene> genes;
-};
+		if(withSequence)
+		{
+			// sekwencja zaraz za indeksem maszyn
+			sequence = reinterpret_cast<core::uint16*>(genes8 + machineBytes);
+			blockBytes = machineBytes + numGenes * sizeof(core::uint16);
+		}
+	}
 
-class Problem;
+	// Rozmiar pamieci na geny, indeks maszyn i sekwencje
+	static core::uint32 storageBytes(core::uint32 numGenes, core::uint32 geneBytes,
+		core::uint32 numMachines, core::uint32 numJobs, bool withSequence)
+	{
+		core::uint32 bytes = indexOffset(numGenes, geneBytes) + indexBytes(numGenes, numMachines, numJobs);
+		if(withSequence)
+			bytes += numGenes * sizeof(core::uint16);
+		return bytes;
+	}
 
-// * Jedno z rozwiazan
-struct Genome
-{
-	Genome(Problem& p);
+	// Kopiuje geny w miejscu (oba genomy musza nalezec do tego samego problemu)
+	Genome& operator=(const Genome& other)
+	{
+		assert(numGenes == other.numGenes && blockBytes == other.blockBytes);
+		memcpy(genes8, other.genes8, blockBytes);
+		objective = other.objective;
+		fitness = other.fitness;
+		rejected = other.rejected;
+		memcpy(objectives, other.objectives, sizeof(objectives));
+		rank = other.rank;
+		crowding = other.crowding;
+		return *this;
+	}
+
+	// Maszyna dla operacji o indeksie 'op' (indeks w plaskiej tablicy genow)
+	core::uint32 machine(core::uint32 op) const
+	{
+		return geneBytes == 1 ? genes8[op] : genes16[op];
+	}
+	// Maszyna dla operacji 'op' zadania 'job'
+	core::uint32 machine(core::uint32 job, core::uint32 op) const
+	{
+		return machine(rowOffsets[job] + op);
+	}
+
+	// Sam gen, bez indeksu maszyn (ten trzeba potem odbudowac lub uzyc Problem::reassign)
+	void setMachine(core::uint32 op, core::uint32 machine)
+	{
+		if(geneBytes == 1)
+			genes8[op] = static_cast<core::uint8>(machine);
+		else
+			genes16[op] = static_cast<core::uint16>(machine);
+	}
+
+	// Kopiuje geny razem z indeksem maszyn z 'other' (bez sekwencji)
+	void copyMachines(const Genome& other)
+	{
+		memcpy(genes8, other.genes8, machineBytes);
+	}
+
+	// Liczba operacji na maszynie 'm'
+	core::uint32 machineCount(core::uint32 m) const
+	{
+		return machineStart[m + 1] - machineStart[m];
+	}
+
+	// Operacja na pozycji 'pos' indeksu maszyn
+	core::uint32 machineOp(core::uint32 pos) const
+	{
+		return wideIndex ? machineOps32[pos] : machineOps16[pos];
+	}
+	// Pozycja operacji 'op' w indeksie maszyn
+	core::uint32 slot(core::uint32 op) const
+	{
+		return wideIndex ? opSlot32[op] : opSlot16[op];
+	}
+	// Operacja 'op' na pozycji 'pos' (obie strony indeksu)
+	void place(core::uint32 pos, core::uint32 op)
+	{
+		if(wideIndex)
+		{
+			machineOps32[pos] = op;
+			opSlot32[op] = pos;
+		}
+		else
+		{
+			machineOps16[pos] = static_cast<core::uint16>(op);
+			opSlot16[op] = static_cast<core::uint16>(pos);
+		}
+	}
+	// Pozycja poza indeksem (numGenes) - przy odtwarzaniu indeksu
+	void clearSlot(core::uint32 op)
+	{
+		if(wideIndex)
+			opSlot32[op] = numGenes;
+		else
+			opSlot16[op] = static_cast<core::uint16>(numGenes);
+	}
 
-	// Zbior wierszy genow = tabelka = jedno z rozwiazan
-	std::vector<JobGene> rows;
-	core::uint32 objective;
+	// Przenosi operacje w indeksie z segmentu maszyny 'from' do 'to'. Operacja
+	// przechodzi przez granice kolejnych segmentow - O(|from - to|) zamian
+	void moveInIndex(core::uint32 op, core::uint32 from, core::uint32 to)
+	{
+		core::uint32 pos = slot(op);
+		for(; from < to; ++from)
+		{
+			// na koniec swojego segmentu, granica w lewo - poczatek nastepnego
+			core::uint32 last = machineStart[from + 1] - 1;
+			swapSlots(pos, last);
+			pos = last;
+			machineStart[from + 1]--;
+		}
+		for(; from > to; --from)
+		{
+			// na poczatek swojego segmentu, granica w prawo - koniec poprzedniego
+			core::uint32 first = machineStart[from];
+			swapSlots(pos, first);
+			pos = first;
+			machineStart[from]++;
+		}
+	}
+
+	// Geny wszystkich operacji, wiersz po wierszu = tabelka = jedno z rozwiazan
+	union
+	{
+		core::uint8* genes8;
+		core::uint16* genes16;
+	};
+	// Obciazenie maszyn (suma czasow przydzielonych operacji) i granice segmentow indeksu
+	core::uint32* load;
+	core::uint32* machineStart;
+	// Suma czasow operacji zadania na przydzielonych maszynach
+	core::uint32* jobLoad;
+	// Indeks operacji (machineOp, slot, place) - szerokosc wg wideIndex
+	union
+	{
+		core::uint16* machineOps16;
+		core::uint32* machineOps32;
+	};
+	union
+	{
+		core::uint16* opSlot16;
+		core::uint32* opSlot32;
+	};
+	bool wideIndex;
+	// Kolejnosc operacji (numery zadan), 0 gdy chromosom jej nie zawiera
+	core::uint16* sequence;
+	core::uint32 numGenes;
+	core::uint32 geneBytes;
+	core::uint32 numMachines;
+	core::uint32 machineBytes; // geny + indeks maszyn
+	core::uint32 blockBytes; // geny + indeks maszyn + sekwencja
+	const core::uint32* rowOffsets; // poczatki wierszy w tablicy genow (wspolne dla problemu)
+	core::uint32 objective; // makespan policzony przez dekoder
 	float fitness; // przystosowanie (im mniejsze typ lepsze) - przeskalowane objective (np. dla ruletki)
+	// Dekodowanie przerwane po przekroczeniu progu - objective jest wtedy tylko
+	// dolnym ograniczeniem makespanu (wiekszym od progu)
+	bool rejected;
+
+	// Wektor celow (wszystkie minimalizowane) dla trybu wielokryterialnego
+	enum
+	{
+		OBJ_MAKESPAN,
+		OBJ_TOTAL_WORKLOAD, // suma czasow wszystkich operacji
+		OBJ_MAX_WORKLOAD, // obciazenie najbardziej obciazonej maszyny
+		NUM_OBJECTIVES
+	};
+	core::uint32 objectives[NUM_OBJECTIVES];
+	// Front niezdominowany (0 - najlepszy) i odleglosc zatloczenia (FM_NSGA2)
+	core::uint32 rank;
+	float crowding;
+
+private:
+	Genome(const Genome&);
+
+	// indeks maszyn zaczyna sie za genami, wyrownany do 4 bajtow
+	static core::uint32 indexOffset(core::uint32 numGenes, core::uint32 geneBytes)
+	{
+		return (numGenes * geneBytes + 3) & ~3U;
+	}
+	static core::uint32 indexBytes(core::uint32 numGenes, core::uint32 numMachines, core::uint32 numJobs)
+	{
+		core::uint32 opBytes = numGenes > 0xFFFF ? sizeof(core::uint32) : sizeof(core::uint16);
+		core::uint32 bytes = (numMachines + (numMachines + 1) + numJobs) * sizeof(core::uint32) +
+			2 * numGenes * opBytes;
+		// sekwencja (uint16) zaraz za indeksem
+		return (bytes + 3) & ~3U;
+	}
+
+	void swapSlots(core::uint32 a, core::uint32 b)
+	{
+		core::uint32 opA = machineOp(a);
+		core::uint32 opB = machineOp(b);
+		place(a, opB);
+		place(b, opA);
+	}
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -54,7 +272,6 @@ class QString;
 // * Wczytany problem do rozwiazania.
 class Problem
 {
-	friend struct Genome;
 public:
 	Problem();
 	~Problem();
@@ -91,17 +308,54 @@ public:
 	{
 		FM_LINEARRANKING,
 		FM_SIGMASCALING,
-		FM_RAWVALUE
+		FM_RAWVALUE,
+		// Wielokryterialny NSGA-II (makespan, calkowite i maksymalne obciazenie):
+		// przetrwanie (mu + lambda) wg frontow i odleglosci zatloczenia,
+		// fitness - ranking liniowy w tym porzadku
+		FM_NSGA2
+	};
+
+	enum EDecoder
+	{
+		// Each operation starts as soon as both its job and its machine
+		// are free; operations on a machine follow the column order.
+		DC_SEMIACTIVE,
+		// Like semi-active, but an operation is inserted into the earliest
+		// idle gap of its machine that is long enough to hold it.
+		DC_ACTIVE,
+		// Giffler-Thompson: find the operation with the earliest completion,
+		// then among the operations on its machine that could start before
+		// that time pick the one that comes first in the sequence.
+		DC_GT_ACTIVE,
+		// Giffler-Thompson non-delay: find the operation with the earliest
+		// start, then among the operations on its machine that can start
+		// at that time pick the one that comes first in the sequence.
+		DC_GT_NONDELAY
 	};
 
 	void clearData();
 	void clearAllSolutions();
 	bool loadInitialData(const char* filename);
+	// To samo ze strumienia (np. dane przeslane przez siec)
+	bool loadInitialData(std::istream& in);
+	// Dane problemu z innego obiektu (bez ponownego czytania pliku)
+	bool copyInitialData(const Problem& source);
+	// Ziarno generatora liczb losowych (domyslnie z zegara)
+	void setSeed(core::uint32 seed)
+	{
+		rnd.srand(seed);
+	}
 	void generateRandomSolutions(core::uint32 populationSize);
 	void showPopulation();
 	void showPopulationStats();
+	void showProfile();
+	void showPerfCounters();
+	void showScreening();
 	#if defined(EVO_QT_SUPPORT)
 	void getPopulationDesc(QString& desc);
+	void getProfileDesc(QString& desc);
+	void getPerfDesc(QString& desc);
+	void getScreeningDesc(QString& desc);
 	#endif
 
 	// Ustawia prawdopodobienstwo krzyzowaia i mutacji nowych osobnikow
@@ -167,6 +421,56 @@ public:
 		replaceCoeff = std::max(std::min(ReplaceCoeff, 1.0f), 0.0f);
 	}
 
+	// Proba umieszczenia populacji na duzych stronach (przy nastepnym generateRandomSolutions)
+	void setHugePages(bool enable)
+	{
+		hugePages = enable;
+	}
+
+	// Sposob budowania harmonogramu z przydzialu maszyn.
+	// Kolejnosc operacji bierze sie z sekwencji genomu, a bez niej z kolejnosci
+	// kolumnowej (pierwsze operacje wszystkich zadan, potem drugie, ...)
+	void setDecoder(EDecoder dc)
+	{
+		decoder = dc;
+	}
+
+	// Dekodowanie potomkow z progiem: dekoder przerywa prace gdy makespan na pewno
+	// przekroczy prog (potomek i tak nie trafilby do populacji lub bylby gorszy
+	// od najgorszego). Prog wynika z modelu populacji, PM_SS_UNIFORM go nie ma
+	void setBoundedDecoding(bool enable)
+	{
+		boundedDecoding = enable;
+	}
+
+	// Wstepna ocena potomkow surogatem (najbardziej obciazona maszyna lub najdluzsze
+	// zadanie) przed pelnym dekodowaniem. Potomek jest odrzucany bez dekodowania gdy
+	// surogat * factor przekracza prog akceptacji (jak w setBoundedDecoding).
+	// factor == 1 odrzuca tylko potomkow na pewno gorszych, wieksze wartosci odrzucaja
+	// agresywniej kosztem czesci dobrych potomkow. Co 'auditPeriod'-ty odrzucony jest
+	// mimo to dekodowany, zeby oszacowac ilu dobrych potomkow gubi (0 - bez audytu).
+	// factor <= 0 wylacza
+	void setScreening(float factor, core::uint32 auditPeriod)
+	{
+		screenFactor = factor;
+		screenAuditPeriod = auditPeriod;
+	}
+
+	// Dodaje do chromosomu sekwencje operacji (krzyzowanie POX, mutacje swap/insert).
+	// Musi byc ustawione przed generateRandomSolutions
+	void setSequenceChromosome(bool enable)
+	{
+		useSequence = enable;
+	}
+
+	// Lokalne przeszukiwanie (memetyczne) 'topK' najlepszych potomkow kazdego pokolenia,
+	// najwyzej 'maxIterations' zaakceptowanych ruchow na osobnika. topK == 0 wylacza
+	void setLocalSearch(core::uint32 topK, core::uint32 maxIterations)
+	{
+		lsTopK = topK;
+		lsMaxIterations = maxIterations;
+	}
+
 	void setGenitor(bool enable)
 	{
 		genitor = enable;
@@ -194,12 +498,190 @@ public:
 		pickUnused = allowDuplicates;
 	}
 
+	// Operatory zmiennosci - kazdy dostaje nagrode za wzgledna poprawe makespanu
+	// potomka wzgledem lepszego z rodzicow (mutacja - wzgledem osobnika mutowanego)
+	enum EOperator
+	{
+		OP_ROW_CX,
+		OP_COLUMN_CX,
+		OP_MUTATION,
+		OP_COUNT
+	};
+
+	// Adaptacyjny dobor operatorow (adaptive pursuit): jakosc operatora to srednia
+	// wykladnicza (wsp. 'alpha') nagrod z pokolenia, prawdopodobienstwo najlepszego
+	// operatora zbliza sie (wsp. 'beta') do maksimum, pozostalych do 'minProb'.
+	// Po kazdym pokoleniu z prawdopodobienstw wynikaja probCX, probMUT (suma jak
+	// w setProbability) i probOperator. Stan startowy - przy generateRandomSolutions
+	void setAdaptiveOperators(bool enable, float alpha = 0.3f, float beta = 0.3f, float minProb = 0.1f)
+	{
+		adaptive = enable;
+		adaptAlpha = alpha;
+		adaptBeta = beta;
+		adaptMinProb = std::max(std::min(minProb, 1.0f / OP_COUNT), 0.0f);
+	}
+
+	// Przebieg adaptacji (stan po kazdym pokoleniu) zapisywany na biezaco do pliku -
+	// w pamieci nic sie nie gromadzi. 0 zamyka plik
+	bool setOperatorLog(const char* filename);
+
 	// Nastepne pokolenie
 	void nextGen();
+	// Liczba pokolen od generateRandomSolutions
+	core::uint32 getGeneration() const { return generation; }
+
+	// Warunki zatrzymania sprawdzane przez shouldStop() po kazdym pokoleniu
+	// (0 - warunek wylaczony). Czas i brak poprawy liczone sa od
+	// generateRandomSolutions (lub loadCheckpoint). Czas jest sprawdzany miedzy
+	// pokoleniami - dla twardego terminu najlepsze rozwiazanie daje getBestSchedule
+	struct StopConditions
+	{
+		double timeLimit; // sekundy (czas scienny)
+		core::uint64 maxEvaluations; // dekodowania (bez populacji poczatkowej)
+		core::uint32 maxGenerations;
+		core::uint32 stagnation; // pokolenia bez poprawy najlepszego rozwiazania
+		core::uint32 target; // wystarczajacy makespan
+
+		StopConditions() : timeLimit(0.0), maxEvaluations(0), maxGenerations(0), stagnation(0), target(0) {}
+	};
 
-	// Wynik wypisz do matlab'a
+	enum EStopReason
+	{
+		SR_NONE,
+		SR_TIME,
+		SR_EVALUATIONS,
+		SR_GENERATIONS,
+		SR_STAGNATION,
+		SR_TARGET,
+		// osiagniete dolne ograniczenie - zawsze sprawdzane
+		SR_LOWER_BOUND
+	};
+
+	void setStopConditions(const StopConditions& sc) { stopConditions = sc; }
+	const StopConditions& getStopConditions() const { return stopConditions; }
+	// Sprawdza warunki i zapamietuje powod zatrzymania
+	bool shouldStop();
+	EStopReason getStopReason() const { return stopReason; }
+	static const char* stopReasonName(EStopReason reason);
+	// nextGen az do spelnienia ktoregos z warunkow
+	EStopReason run();
+	// Sekundy od generateRandomSolutions
+	double getElapsedTime() const { return omp_get_wtime() - stopStart; }
+	// Pokolenia od ostatniej poprawy najlepszego rozwiazania
+	core::uint32 getStagnation() const { return generation - bestGeneration; }
+	core::uint32 getBestObjective() const { return bestObjective; }
+
+	// Najlepsze dotad rozwiazanie dostepne z innego watku w dowolnej chwili
+	// (np. po uplywie terminu, gdy pokolenie jeszcze trwa). Po poprawie algorytm
+	// dekoduje je do drugiego bufora i podmienia pod omp_test_lock - czytajacy
+	// nigdy nie wstrzymuje algorytmu, najwyzej podmiana czeka do nastepnego pokolenia
+	void setAnytime(bool enable) { anytime = enable; }
+	// false gdy jeszcze nic nie opublikowano
+	bool getBestSchedule(ScheduleTable& table);
+
+	// Obraz pelnego stanu (obie populacje z przydzialem maszyn, indeksem i celami,
+	// statystyki, stan generatora liczb losowych, ustawienia) co 'every' pokolen
+	// do 'filename'. Obraz powstaje w pamieci, plik jest zapisywany w tle.
+	// every == 0 wylacza
+	void setCheckpoint(const char* filename, core::uint32 every);
+	// Zapis synchroniczny (czeka tez na zapisy w tle)
+	bool saveCheckpoint(const char* filename);
+	// Wznowienie zamiast generateRandomSolutions - problem musi byc wczytany
+	// (ten sam plik). Przywraca tez wszystkie ustawienia; w jednym watku dalszy
+	// przebieg jest identyczny jak bez przerwy
+	bool loadCheckpoint(const char* filename);
+
+	// Rozmiar wczytanego problemu
+	core::uint32 getNumJobs() const { return numJobs; }
+	core::uint32 getNumMachines() const { return numMachines; }
+	core::uint32 getNumOps() const { return numOps; }
+
+	// Dolne ograniczenie makespanu liczone przy wczytywaniu problemu:
+	// max(najdluzsze zadanie, calkowita praca / liczba maszyn), kazda operacja
+	// liczona z najkrotszym czasem wykonania
+	core::uint32 getLowerBound() const { return lowerBound; }
+	core::uint32 getJobBound() const { return jobBound; }
+	core::uint32 getWorkloadBound() const { return workloadBound; }
+	// Najlepsze rozwiazanie osiagnelo dolne ograniczenie - jest optymalne
+	bool reachedLowerBound() const { return minObjective <= lowerBound; }
+	// Wzgledna odleglosc najlepszego rozwiazania od dolnego ograniczenia
+	float optimalityGap() const
+	{
+		return lowerBound ? static_cast<float>(minObjective - lowerBound) / lowerBound : 0.0f;
+	}
+
+	// Zapisuje front niezdominowany biezacej populacji (FM_NSGA2): wektor celow
+	// i przydzial maszyn kazdego rozwiazania, bez powtorzen wektora celow
+	bool outputPareto(const char* filename);
+
+	// Harmonogram rozwiazania (czasy liczone dekoderem) w ukladzie kolumnowym.
+	// Genom zostaje bez zmian (cele, liczniki dekodowan)
+	void getSchedule(const Genome& gen, ScheduleTable& table);
+	// To samo dla osobnika biezacej populacji (0 - najlepszy)
+	void getSchedule(core::uint32 genomeIndex, ScheduleTable& table);
+	// Zapisuje harmonogramy 'topK' pierwszych osobnikow biezacej populacji
+	// (w kolejnosci sortowania) do jednego pliku CSV lub binarnego
+	bool outputSchedule(const char* filename, ScheduleWriter::EFormat format, core::uint32 topK = 1);
+
+	// Wynik wypisz do matlab'a (skrypt dla bin/plotgantt.m)
 	bool outputToMatlab(const char* filename, core::uint32 genomeIndex = 0);
-	bool outputToMatlab(const char* filename, Genome& gen);
+	bool outputToMatlab(const char* filename, const Genome& gen);
+
+	// Koszt i skutecznosc lokalnego przeszukiwania (od generateRandomSolutions)
+	struct LocalSearchStats
+	{
+		core::uint32 calls; // przeszukanych osobnikow
+		core::uint32 improved; // osobnikow z lepszym makespanem
+		core::uint64 evaluations; // dekodowan w trakcie przeszukiwania
+		core::uint64 moves; // zaakceptowanych ruchow
+		double seconds; // czas scienny
+	};
+	const LocalSearchStats& getLocalSearchStats() const { return lsStats; }
+
+	// Skutecznosc wstepnej oceny (od generateRandomSolutions). Pozytywny - potomek
+	// nie gorszy od progu akceptacji
+	struct ScreeningStats
+	{
+		core::uint64 passed; // przepuszczonych do dekodowania
+		core::uint64 passedGood; // w tym faktycznie dobrych
+		core::uint64 screenedOut; // odrzuconych przez surogat
+		core::uint64 audited; // odrzuconych, ale zdekodowanych kontrolnie
+		core::uint64 auditedGood; // w tym dobrych (odrzuconych niesluszne)
+
+		double precision() const
+		{
+			return passed ? static_cast<double>(passedGood) / passed : 0.0;
+		}
+		// dobrzy odrzuceni szacowani z proby audytowej
+		double recall() const
+		{
+			double lost = audited ? static_cast<double>(auditedGood) * screenedOut / audited : 0.0;
+			return passedGood + lost > 0.0 ? passedGood / (passedGood + lost) : 1.0;
+		}
+		// dekodowan ktorych nie trzeba bylo wykonac
+		core::uint64 skipped() const { return screenedOut - audited; }
+	};
+	ScreeningStats getScreeningStats() const;
+
+	// Liczba dekodowan i dekodowan przerwanych z powodu progu (od generateRandomSolutions)
+	core::uint64 getDecodeCount() const;
+	core::uint64 getRejectedCount() const;
+
+	// Liczniki cykli poszczegolnych faz (wypelniane tylko z EVO_PROFILE)
+	const Profiler& getProfiler() const { return profiler; }
+
+	// Wlacza sprzetowe liczniki wydajnosci dla faz nextGen.
+	// Zwraca false gdy liczniki nie sa dostepne (wtedy nic nie jest mierzone)
+	bool setPerfCounters(bool enable);
+	bool isPerfAvailable() const { return perf.isAvailable(); }
+	// Liczniki z ostatniego pokolenia oraz sumaryczne od wlaczenia
+	core::uint64 getPerfGeneration(EPerfPhase phase, EPerfEvent e) const { return perfGen[phase][e]; }
+	core::uint64 getPerfTotal(EPerfPhase phase, EPerfEvent e) const { return perfTotal[phase][e]; }
+
+	#if defined(EVO_TRACE)
+	// Zapisuje przebieg watkow (od generateRandomSolutions) jako Chrome trace JSON
+	bool writeTrace(const char* filename) const { return tracer.write(filename); }
+	#endif
 
 private:
 	std::vector<Job> jobs;
@@ -208,24 +690,92 @@ private:
 	Population pop;
 	Population tmpPop;
 
+	// Pamiec dla wszystkich genomow z pop i tmpPop
+	GenomePool pool;
+	bool hugePages;
+
+	// FM_NSGA2: sortowanie niezdominowane i suma rodzicow i potomkow
+	ParetoSorter pareto;
+	Population paretoPop;
+
 	int indexPop;
+	core::uint32 generation;
+
+	std::string checkpointFile;
+	core::uint32 checkpointEvery;
+	CheckpointWriter checkpointWriter;
+	std::vector<char> checkpointData;
 	float replaceCoeff;
 	core::uint32 tempPopSize;
 
 	core::uint32 numMachines;
 	core::uint32 numJobs;
 	core::uint32 maxOps;
+	// Liczba operacji wszystkich zadan i poczatki wierszy w tablicy genow
+	core::uint32 numOps;
+	std::vector<core::uint32> rowOffsets;
+	// Rozmiar genu w bajtach (1 dla <= 256 maszyn, 2 w p.p.)
+	core::uint32 geneBytes;
+	// Domyslna kolejnosc operacji (kolumnowa) - dla genomow bez sekwencji
+	std::vector<core::uint16> defaultSequence;
+	// Zadanie do ktorego nalezy operacja (indeks w plaskiej tablicy genow)
+	std::vector<core::uint32> opJob;
+	// Najkrotszy czas wykonania operacji (na dowolnej maszynie)
+	std::vector<core::uint32> opMinCost;
+	// Czasy wykonania operacji w plaskiej tablicy: costTable[op * numMachines + maszyna]
+	std::vector<core::uint32> costTable;
+	core::uint32 jobBound;
+	core::uint32 workloadBound;
+	core::uint32 lowerBound;
 	core::Random rnd;
 
 	ESelectionScheme ssMethod;
 	EPopulationModel popModel;
 	EFitnessModel fitModel;
+	EDecoder decoder;
+	bool useSequence;
 	bool genitor;
+	bool boundedDecoding;
+	// prog dla dekodera w biezacym pokoleniu (NO_CUTOFF - bez progu)
+	core::uint32 decodeCutoff;
+	enum { NO_CUTOFF = 0xFFFFFFFF };
+	// prog akceptacji potomka w biezacym pokoleniu, niezaleznie od boundedDecoding
+	core::uint32 acceptThreshold;
+	float screenFactor;
+	core::uint32 screenAuditPeriod;
+	core::uint32 lsTopK;
+	core::uint32 lsMaxIterations;
+	// ilu najlepiej ocenionych kandydatow sprawdzac dekoderem w kazdym kroku
+	enum { LS_CANDIDATES = 8 };
+	LocalSearchStats lsStats;
 	float sp; // selective pressure
 	float probCX;
 	float probMUT;
 	// prawdopodobienstwo wyboru jednego z dwoch operator krzyzowania
 	float probOperator;
+	// setAdaptiveOperators
+	bool adaptive;
+	float adaptAlpha;
+	float adaptBeta;
+	float adaptMinProb;
+	float adaptBudget; // probCX + probMUT
+	float opQuality[OP_COUNT];
+	float opProb[OP_COUNT];
+	core::uint32 opUses[OP_COUNT]; // w ostatnim pokoleniu
+	FILE* operatorLog;
+	// setStopConditions
+	StopConditions stopConditions;
+	EStopReason stopReason;
+	// omp_get_wtime() przy starcie - core::Timer na Windows przypina watek do CPU 0
+	double stopStart;
+	core::uint32 bestObjective; // najlepszy od startu
+	core::uint32 bestGeneration;
+	// setAnytime: anytimeFront - dla czytajacych (pod anytimeLock), anytimeBack - dla algorytmu
+	bool anytime;
+	bool anytimePending;
+	ScheduleTable anytimeFront;
+	ScheduleTable anytimeBack;
+	omp_lock_t anytimeLock;
 	core::uint32 tourGroupSize;
 	bool pickUnused;
 
@@ -233,13 +783,185 @@ private:
 	struct rgb { float r, g, b; };
 	std::vector<rgb> colors;
 
-	// Liczy wartosc funkcji celu dla pojedynczego rozwiazania
-	core::uint32 objectiveScore(Genome& gen);
+	Profiler profiler;
+	#if defined(EVO_TRACE)
+	Tracer tracer;
+	#endif
+
+	PerfCounters perf;
+	core::uint64 perfGen[PF_COUNT][PE_COUNT];
+	core::uint64 perfTotal[PF_COUNT][PE_COUNT];
+	core::uint32 perfGenerations;
+
+	// Liczy wartosc funkcji celu dla pojedynczego rozwiazania (z policzonych czasow rozpoczecia)
+	core::uint32 objectiveScore(const Genome& gen, const core::uint32* times);
 	// Oblicza wsp. przystosowania kazdego z osobnikow z populacji (przeskalowana wartosc funkcji celu)
 	void fitness(Population& pop);
 
-	// Liczy czas rozpoczecia procesu na maszynach z uwzglednieniem zaleznosci i zajecia maszyn
-	core::uint32 computeStartingTime(Genome& gen);
+	// Liczy czas rozpoczecia procesu na maszynach z uwzglednieniem zaleznosci i zajecia maszyn.
+	// Zapisuje makespan w gen.objective, czasy (indeksowane jak geny) tylko gdy times != 0
+	core::uint32 computeStartingTime(Genome& gen, core::uint32* times = 0);
+	// To samo bez profilowania (lokalne przeszukiwanie liczy swoje dekodowania osobno)
+	core::uint32 decodeGenome(Genome& gen, core::uint32* times = 0);
+	// Wlasciwe dekodowanie z podanym progiem (bez wstepnej oceny)
+	core::uint32 decodeBounded(Genome& gen, core::uint32* times, core::uint32 cutoff);
+	// Sam dekoder wybrany przez setDecoder - bez zmian w genomie
+	core::uint32 runDecoder(const Genome& gen, core::uint32* times, core::uint32 cutoff);
+	// Ustawia objective i wektor celow genomu
+	core::uint32 setObjectives(Genome& gen, core::uint32 makespan);
+	// Dekodery. Zadanie nie skonczy sie przed jobLoad + czas oczekiwania, a maszyna
+	// (gdy operacje sa tylko dokladane na koniec) przed load + czas przestoju.
+	// Przy cutoff != NO_CUTOFF dekoder konczy prace gdy to ograniczenie przekroczy
+	// cutoff i zwraca je zamiast makespanu
+	void initSlack(const Genome& gen, core::uint32 cutoff);
+	template<typename T>
+	core::uint32 decode(const T* machines, const core::uint16* seq, core::uint32* times,
+		const Genome& gen, core::uint32 cutoff);
+	template<typename T>
+	core::uint32 decodeActive(const T* machines, const core::uint16* seq, core::uint32* times,
+		const Genome& gen, core::uint32 cutoff);
+	template<typename T>
+	core::uint32 decodeGifflerThompson(const T* machines, const core::uint16* seq,
+		core::uint32* times, bool nonDelay, const Genome& gen, core::uint32 cutoff);
+
+	// Przedzial czasu [begin, end) na maszynie
+	struct Interval { core::uint32 begin, end; };
+
+	// Operacja gotowa do uszeregowania (Giffler-Thompson): koniec poprzednika
+	// w zadaniu, czas wykonania na przydzielonej maszynie i pozycja w sekwencji
+	struct ReadyOp { core::uint32 ready, cost, priority, job; };
+
+	// Ruch lokalnego przeszukiwania z oszacowaniem makespanu po jego wykonaniu
+	enum ELocalMove
+	{
+		LM_REASSIGN, // operacja 'op' na maszyne 'target'
+		LM_FRONT, // operacja 'op' przed operacje 'target' (poczatek bloku)
+		LM_BACK // operacja 'op' za operacje 'target' (koniec bloku)
+	};
+	struct LocalMove
+	{
+		core::uint32 estimate;
+		core::uint32 op;
+		core::uint32 target;
+		core::uint32 origin; // LM_REASSIGN: poprzednia maszyna
+		ELocalMove kind;
+
+		bool operator<(const LocalMove& other) const { return estimate < other.estimate; }
+	};
+
+	// Bufory robocze dekodera i operatorow - osobne dla kazdego watku OpenMP,
+	// dzieki temu dekodowanie nie alokuje pamieci
+	struct ThreadScratch
+	{
+		std::vector<core::uint32> machineTime; // koniec ostatniej operacji na maszynie
+		std::vector<core::uint32> jobTime; // koniec ostatniej operacji zadania
+		// luki na maszynach (dekoder aktywny): maszyna m ma swoj ciagly
+		// segment w 'gaps' od gapFirst[m], posortowany po czasie, gapCount[m] elementow
+		std::vector<core::uint32> gapFirst;
+		std::vector<core::uint32> gapCount;
+		std::vector<Interval> gaps;
+		// Giffler-Thompson: nastepna operacja zadania, priorytet (pozycja w sekwencji) operacji
+		std::vector<core::uint32> nextOp;
+		std::vector<core::uint32> priority;
+		// Giffler-Thompson: operacje gotowe do uszeregowania na maszynie m (ciagly
+		// segment w 'ready' od readyFirst[m], readyCount[m] elementow) i najwczesniejszy
+		// koniec (start) wsrod nich
+		std::vector<core::uint32> readyFirst;
+		std::vector<core::uint32> readyCount;
+		std::vector<core::uint32> readyBest;
+		std::vector<ReadyOp> ready;
+		// POX: zadania dziedziczone z pierwszego rodzica
+		std::vector<core::uint8> jobMask;
+		// dekodowanie z progiem: zapas czasu maszyn i zadan, liczniki
+		std::vector<core::int32> machineSlack;
+		std::vector<core::int32> jobSlack;
+		// czasy rozpoczecia dla getSchedule
+		std::vector<core::uint32> times;
+		core::uint64 decodes;
+		core::uint64 rejected;
+		// wstepna ocena (ScreeningStats)
+		ScreeningStats screening;
+		// adaptacja operatorow: uzycia i suma nagrod w biezacym pokoleniu
+		core::uint32 opUses[OP_COUNT];
+		double opCredit[OP_COUNT];
+		// Graf harmonogramu (criticalPath): glowy (czasy rozpoczecia) i ogony operacji,
+		// operacje w kolejnosci czasu, kolejnosc na maszynach (segment maszyny m
+		// to [machineFirst[m], machineFirst[m+1]) w machineOps) i pozycja operacji w niej
+		std::vector<core::uint32> head;
+		std::vector<core::uint32> tail;
+		std::vector<core::uint32> order;
+		std::vector<core::uint32> machineFirst;
+		std::vector<core::uint32> machineOps;
+		std::vector<core::uint32> machinePos;
+		std::vector<core::uint32> path;
+		core::uint32 pathLength;
+		// Lokalne przeszukiwanie: pozycje operacji w sekwencji, kandydaci,
+		// zmieniony fragment bloku i jego nowe glowy
+		std::vector<core::uint32> seqPos;
+		std::vector<LocalMove> moves;
+		std::vector<core::uint32> segment;
+		std::vector<core::uint32> segmentHead;
+	};
+	std::vector<ThreadScratch> scratch;
+
+	ThreadScratch& threadScratch()
+	{
+		int t = omp_get_thread_num();
+		assert(t < static_cast<int>(scratch.size()));
+		return scratch[t];
+	}
+
+	// Czas wykonania operacji 'op' na maszynie 'machine'
+	core::uint32 opCost(core::uint32 op, core::uint32 machine) const
+	{
+		return costTable[op * numMachines + machine];
+	}
+
+	// Przydziela operacje 'op' do maszyny 'machine' aktualizujac obciazenia i indeks maszyn
+	void reassign(Genome& gen, core::uint32 op, core::uint32 machine)
+	{
+		core::uint32 old = gen.machine(op);
+		if(old == machine)
+			return;
+
+		core::uint32 oldCost = opCost(op, old);
+		core::uint32 newCost = opCost(op, machine);
+		gen.load[old] -= oldCost;
+		gen.load[machine] += newCost;
+		gen.jobLoad[opJob[op]] += newCost - oldCost;
+		gen.moveInIndex(op, old, machine);
+		gen.setMachine(op, machine);
+	}
+	// Buduje obciazenia i indeks maszyn od zera (po ustawieniu genow przez setMachine)
+	void buildMachineIndex(Genome& gen);
+	// Jak wyzej, ale z zadana kolejnoscia operacji w segmentach maszyn (wznowienie)
+	bool restoreMachineIndex(Genome& gen, const core::uint32* ops);
+
+	// Tablice pochodne danych problemu (offsety, ograniczenia, bufory watkow)
+	bool prepareData();
+	// Pamiec i wskazniki obu populacji
+	void allocatePopulations(core::uint32 populationSize);
+	// Obraz stanu (setCheckpoint) i jego odtworzenie
+	void serialize(std::vector<char>& data);
+	bool deserialize(const std::vector<char>& data);
+	// Skrot danych problemu - obraz pasuje tylko do tego samego problemu
+	core::uint64 problemHash() const;
+
+	// Dekoduje genom i buduje graf harmonogramu w buforach watku: glowy, ogony,
+	// kolejnosc na maszynach oraz sciezke krytyczna (sc.path). Zwraca makespan
+	core::uint32 criticalPath(Genome& gen);
+	// Oszacowanie makespanu gdy blok operacji jednej maszyny zostanie zastapiony
+	// przez 'seg' (ta sama maszyna); mpEnd - koniec poprzednika, ms - nastepnik na maszynie
+	core::uint32 estimateSegment(const Genome& gen, const core::uint32* seg, core::uint32 n,
+		core::uint32 mpEnd, core::uint32 ms);
+	// Ruchy N5/N7 (zamiany i przeniesienia w blokach krytycznych) oraz przeniesienia
+	// operacji krytycznych na inne maszyny. Akceptuje ruchy nie pogarszajace makespanu
+	bool localSearch(Genome& gen, core::uint64& evaluations, core::uint64& moves);
+	// Wykonuje (undo == false) lub cofa ruch. Zwraca false gdy ruchu nie da sie
+	// wyrazic w sekwencji (zmienilby kolejnosc operacji tego samego zadania)
+	bool applyLocalMove(Genome& gen, const LocalMove& mv, bool undo);
+	// Lokalne przeszukiwanie najlepszych potomkow (setLocalSearch)
+	void localSearchTop(Population& pop);
 
 	// Oblicza statystyki dla populacji (srednia, min, max, odchylenie)
 	void calcStats(Population& pop);
@@ -261,6 +983,22 @@ private:
 		Genome& kid1, Genome& kid2);
 	void rowCrossover(const Genome& mom, const Genome& dad,
 		Genome& kid1, Genome& kid2);
+	// Warianty tworzace tylko pierwszego potomka (bez genomu tymczasowego)
+	void columnCrossover(const Genome& mom, const Genome& dad, Genome& kid);
+	void rowCrossover(const Genome& mom, const Genome& dad, Genome& kid);
+
+	// Kid dostaje operacje 'op' od 'a', reszte od 'b'
+	void columnCrossoverFill(const Genome& a, const Genome& b, Genome& kid, core::uint32 op);
+	// Kid dostaje zadanie 'job' od 'a', reszte od 'b'
+	void rowCrossoverFill(const Genome& a, const Genome& b, Genome& kid, core::uint32 job);
+
+	// Krzyzowanie sekwencji (POX): losowy podzial zbioru zadan
+	void drawJobMask(core::uint8* mask);
+	// Zadania z 'mask' zostaja na pozycjach z 'a', reszta pozycji w kolejnosci z 'b'
+	void sequenceCrossoverFill(const Genome& a, const Genome& b, Genome& kid,
+		const core::uint8* mask, bool maskValue);
+	// Mutacje sekwencji: zamiana dwoch pozycji lub przeniesienie operacji
+	void mutateSequence(Genome& gen);
 
 	// Metody selekcji
 	Genome& selectUniform(Population& pop);
@@ -277,7 +1015,27 @@ private:
 	void create2New(int i, Population& popSrc, Population& popDst);
 	void nextGenSimple(Population& popSrc, Population& popDst);
 	void nextGenSteadyState(Population& popSrc, Population& popDst);
+	// Nagroda dla operatora: makespan przed ('before') i po zastosowaniu
+	void creditOperator(EOperator op, core::uint32 before, core::uint32 after)
+	{
+		ThreadScratch& sc = threadScratch();
+		sc.opUses[op]++;
+		if(after < before)
+			sc.opCredit[op] += static_cast<double>(before - after) / before;
+	}
+	// Prawdopodobienstwa operatorow z biezacych probCX, probMUT i probOperator
+	void resetAdaptation();
+	// Aktualizacja jakosci i prawdopodobienstw po pokoleniu (setAdaptiveOperators)
+	void adaptOperators();
+	// Start zegara i licznika braku poprawy, pierwsza publikacja (setAnytime)
+	void resetStopState();
+	// Zapamietanie poprawy najlepszego i publikacja dla getBestSchedule
+	void updateBest();
+	// FM_NSGA2: z 'survivors' i 'rest' razem najlepsze survivors.size() wg frontow
+	// i zatloczenia trafia do 'survivors' (posortowane), reszta do 'rest'
+	void survivePareto(Population& survivors, Population& rest);
 
+	// Porzadkuje populacje wg makespanu, a w FM_NSGA2 wg frontow i zatloczenia
 	void sort(Population& pop);
 	float* psum;
 	core::uint32* choices;
@@ -0,0 +1,131 @@
+#include <algorithm>
+
+#include "GanttIndex.h"
+#include "ScheduleExport.h"
+
+using namespace core;
+
+namespace
+{
+	struct BarStartLess
+	{
+		bool operator()(const GanttIndex::Bar& a, const GanttIndex::Bar& b) const
+		{
+			return a.start < b.start || (a.start == b.start && a.end < b.end);
+		}
+	};
+}
+
+// -------------------------------------------------------------------------
+GanttIndex::GanttIndex()
+{
+	clear();
+}
+// -------------------------------------------------------------------------
+void GanttIndex::clear()
+{
+	bars.clear();
+	busyBefore.clear();
+	machineBegin.assign(1, 0);
+	maxEnd = 0;
+}
+// -------------------------------------------------------------------------
+void GanttIndex::build(const ScheduleTable& table, uint32 nMachines)
+{
+	clear();
+	machineBegin.assign(nMachines + 1, 0);
+
+	// * Step 1: sortowanie kubelkowe po maszynie (liczniki -> poczatki)
+	size_t rows = table.rows();
+	for(size_t r = 0; r < rows; ++r)
+	{
+		if(table.machine[r] < nMachines)
+			++machineBegin[table.machine[r] + 1];
+	}
+	for(uint32 m = 0; m < nMachines; ++m)
+		machineBegin[m + 1] += machineBegin[m];
+
+	bars.resize(machineBegin[nMachines]);
+	std::vector<size_t> fill(machineBegin.begin(), machineBegin.end() - 1);
+	for(size_t r = 0; r < rows; ++r)
+	{
+		uint32 m = table.machine[r];
+		if(m >= nMachines)
+			continue;
+
+		Bar& b = bars[fill[m]++];
+		b.start = table.start[r];
+		b.end = table.end[r];
+		b.job = table.job[r];
+		b.op = table.op[r];
+		maxEnd = std::max(maxEnd, b.end);
+	}
+
+	// * Step 2: w obrebie maszyny wg startu i skumulowany czas pracy
+	busyBefore.resize(bars.size());
+	for(uint32 m = 0; m < nMachines; ++m)
+	{
+		std::sort(bars.begin() + machineBegin[m], bars.begin() + machineBegin[m + 1], BarStartLess());
+
+		double sum = 0.0;
+		for(size_t i = machineBegin[m]; i < machineBegin[m + 1]; ++i)
+		{
+			busyBefore[i] = sum;
+			sum += bars[i].end - bars[i].start;
+		}
+	}
+}
+// -------------------------------------------------------------------------
+size_t GanttIndex::firstEndingAfter(uint32 machine, double t) const
+{
+	size_t lo = machineBegin[machine];
+	size_t hi = machineBegin[machine + 1];
+	while(lo < hi)
+	{
+		size_t mid = (lo + hi) / 2;
+		if(bars[mid].end <= t)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+// -------------------------------------------------------------------------
+void GanttIndex::visible(uint32 machine, double t0, double t1, size_t& first, size_t& last) const
+{
+	first = firstEndingAfter(machine, t0);
+
+	size_t lo = first;
+	size_t hi = machineBegin[machine + 1];
+	while(lo < hi)
+	{
+		size_t mid = (lo + hi) / 2;
+		if(bars[mid].start < t1)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	last = lo;
+}
+// -------------------------------------------------------------------------
+double GanttIndex::busyUntil(uint32 machine, double t) const
+{
+	size_t i = firstEndingAfter(machine, t);
+	if(i == machineBegin[machine + 1])
+	{
+		if(i == machineBegin[machine])
+			return 0.0;
+		return busyBefore[i - 1] + (bars[i - 1].end - bars[i - 1].start);
+	}
+
+	// operacja i moze trwac w chwili t
+	return busyBefore[i] + std::max(0.0, t - bars[i].start);
+}
+// -------------------------------------------------------------------------
+double GanttIndex::busy(uint32 machine, double t0, double t1) const
+{
+	if(t1 <= t0)
+		return 0.0;
+	return busyUntil(machine, t1) - busyUntil(machine, t0);
+}
+// -------------------------------------------------------------------------
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "core/Prerequisites.h"
+
+struct ScheduleTable;
+
+// * Indeks harmonogramu po (maszyna, czas) dla wykresu Gantta: operacje
+//   kazdej maszyny posortowane wg startu (na jednej maszynie sie nie nakladaja,
+//   wiec konce sa tez rosnace) plus skumulowany czas pracy.
+//
+//   visible znajduje operacje maszyny przecinajace [t0, t1) wyszukiwaniem
+//   binarnym, a busy - czas zajetosci maszyny w [t0, t1) w O(log n), co
+//   pozwala rysowac zagregowana zajetosc (kolumna pikseli zamiast paskow)
+//   bez przegladania operacji. Koszt rysowania zalezy od liczby pikseli,
+//   nie od liczby operacji.
+class GanttIndex
+{
+public:
+	struct Bar
+	{
+		core::uint32 start;
+		core::uint32 end;
+		core::uint32 job;
+		core::uint32 op;
+	};
+
+	GanttIndex();
+
+	// Przebudowa z harmonogramu (maszyny spoza numMachines sa pomijane)
+	void build(const ScheduleTable& table, core::uint32 numMachines);
+	void clear();
+
+	core::uint32 numMachines() const { return static_cast<core::uint32>(machineBegin.size()) - 1; }
+	core::uint32 makespan() const { return maxEnd; }
+	size_t size() const { return bars.size(); }
+
+	// Zakres [first, last) operacji maszyny przecinajacych [t0, t1)
+	void visible(core::uint32 machine, double t0, double t1, size_t& first, size_t& last) const;
+	const Bar& bar(size_t i) const { return bars[i]; }
+
+	// Czas pracy maszyny w przedziale [t0, t1)
+	double busy(core::uint32 machine, double t0, double t1) const;
+
+private:
+	// operacje maszyny m: bars[machineBegin[m] .. machineBegin[m + 1])
+	std::vector<Bar> bars;
+	std::vector<size_t> machineBegin;
+	// busyBefore[i] - suma czasow operacji przed i-ta na tej samej maszynie
+	std::vector<double> busyBefore;
+	core::uint32 maxEnd;
+
+	// Pierwsza operacja maszyny konczaca sie po t
+	size_t firstEndingAfter(core::uint32 machine, double t) const;
+	// Czas pracy maszyny w [0, t)
+	double busyUntil(core::uint32 machine, double t) const;
+};
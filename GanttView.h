@@ -0,0 +1,321 @@
+#pragma once
+
+#include <QWidget>
+#include <QPainter>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <cmath>
+#include <algorithm>
+
+#include "GanttIndex.h"
+#include "ScheduleExport.h"
+
+// * Wykres Gantta harmonogramu (wiersz na maszyne, os X - czas) rysowany
+//   QPainterem z GanttIndex: dla kazdego widocznego wiersza tylko operacje
+//   przecinajace widoczny przedzial czasu. Gdy na wiersz przypada wiecej
+//   operacji niz zmiesci sie paskow, wiersz jest rysowany jako zajetosc maszyny
+//   w kazdej kolumnie pikseli (odcien - ulamek czasu pracy).
+//
+//   Kolko myszy - powiekszenie osi czasu wokol kursora (z Ctrl - osi maszyn),
+//   przeciaganie lewym przyciskiem - przesuwanie, podwojne klikniecie - caly
+//   harmonogram, podpowiedz nad paskiem - zadanie, operacja, start i koniec.
+class GanttView : public QWidget
+{
+public:
+	GanttView(QWidget* parent = 0)
+	: QWidget(parent), t0(0.0), t1(1.0), m0(0.0), m1(1.0), fullView(true), dragging(false)
+	{
+		setAttribute(Qt::WA_OpaquePaintEvent);
+		setFocusPolicy(Qt::WheelFocus);
+	}
+
+	// Nowy harmonogram - przy calym widoku dopasowuje go do nowego makespanu,
+	// inaczej zostawia powiekszenie
+	void setSchedule(const ScheduleTable& table, core::uint32 numMachines)
+	{
+		index.build(table, numMachines);
+		if(fullView)
+			resetView();
+		else
+			clampView();
+		update();
+	}
+
+	void clearSchedule()
+	{
+		index.clear();
+		resetView();
+		update();
+	}
+
+	void resetView()
+	{
+		t0 = 0.0;
+		t1 = std::max<double>(index.makespan(), 1.0);
+		m0 = 0.0;
+		m1 = std::max<double>(index.numMachines(), 1.0);
+		fullView = true;
+	}
+
+protected:
+	enum
+	{
+		MARGIN_LEFT = 40,
+		MARGIN_BOTTOM = 20,
+		// ponizej tej sredniej szerokosci paska wiersz jest agregowany
+		MIN_BAR_WIDTH = 3,
+		MIN_LABEL_WIDTH = 24,
+		BUSY_LEVELS = 16
+	};
+
+	QRect plotArea() const
+	{
+		return rect().adjusted(MARGIN_LEFT, 0, -1, -MARGIN_BOTTOM);
+	}
+
+	virtual void paintEvent(QPaintEvent*)
+	{
+		QPainter painter(this);
+		painter.fillRect(rect(), palette().window());
+
+		QRect area = plotArea();
+		painter.fillRect(area, Qt::white);
+		if(index.size() == 0 || area.width() <= 0 || area.height() <= 0)
+		{
+			painter.drawText(area, Qt::AlignCenter, "No schedule");
+			return;
+		}
+
+		double pxPerTime = area.width() / (t1 - t0);
+		double rowHeight = area.height() / (m1 - m0);
+		int fontHeight = painter.fontMetrics().height();
+
+		// * Step 1: paski albo zajetosc widocznych wierszy
+		painter.save();
+		painter.setClipRect(area);
+		core::uint32 mFirst = static_cast<core::uint32>(m0);
+		core::uint32 mLast = std::min(index.numMachines(), static_cast<core::uint32>(std::ceil(m1)));
+		for(core::uint32 m = mFirst; m < mLast; ++m)
+		{
+			double y = area.top() + (m - m0) * rowHeight;
+			double barTop = y + rowHeight * 0.1;
+			double barHeight = std::max(rowHeight * 0.8, 1.0);
+
+			size_t first, last;
+			index.visible(m, t0, t1, first, last);
+			if((last - first) * MIN_BAR_WIDTH > static_cast<size_t>(area.width()))
+				paintBusy(painter, area, m, barTop, barHeight);
+			else
+				paintBars(painter, area, first, last, barTop, barHeight, barHeight >= fontHeight);
+		}
+
+		// makespan
+		double xEnd = area.left() + (index.makespan() - t0) * pxPerTime;
+		painter.setPen(Qt::red);
+		painter.drawLine(QPointF(xEnd, area.top()), QPointF(xEnd, area.bottom()));
+		painter.restore();
+
+		// * Step 2: osie
+		painter.setPen(palette().color(QPalette::WindowText));
+		painter.drawRect(area);
+		if(rowHeight >= fontHeight)
+		{
+			for(core::uint32 m = mFirst; m < mLast; ++m)
+			{
+				double y = area.top() + (m - m0 + 0.5) * rowHeight;
+				if(y < area.top() || y > area.bottom())
+					continue;
+				painter.drawText(QRectF(0, y - fontHeight, MARGIN_LEFT - 4, 2 * fontHeight),
+					Qt::AlignRight | Qt::AlignVCenter, QString("M%1").arg(m + 1));
+			}
+		}
+
+		// podzialka co 1, 2 lub 5 * 10^k, ok. 80 pikseli
+		double step = std::pow(10.0, std::floor(std::log10(80.0 / pxPerTime)));
+		if(step * pxPerTime < 40.0)
+			step *= step * pxPerTime < 16.0 ? 5.0 : 2.0;
+		step = std::max(step, 1.0);
+		for(double t = std::ceil(t0 / step) * step; t <= t1; t += step)
+		{
+			double x = area.left() + (t - t0) * pxPerTime;
+			painter.drawLine(QPointF(x, area.bottom()), QPointF(x, area.bottom() + 4));
+			painter.drawText(QRectF(x - 40, area.bottom() + 4, 80, MARGIN_BOTTOM - 4),
+				Qt::AlignHCenter | Qt::AlignTop, QString::number(t, 'f', 0));
+		}
+	}
+
+	// Wiersz w postaci zagregowanej - odcien kolumny wg zajetosci, sasiednie
+	// kolumny o tym samym odcieniu jednym prostokatem
+	void paintBusy(QPainter& painter, const QRect& area, core::uint32 m, double top, double height)
+	{
+		double timePerPx = (t1 - t0) / area.width();
+		int runStart = 0;
+		int runLevel = 0;
+		for(int px = 0; px <= area.width(); ++px)
+		{
+			int level = -1;
+			if(px < area.width())
+			{
+				double ta = t0 + px * timePerPx;
+				double u = index.busy(m, ta, ta + timePerPx) / timePerPx;
+				level = std::min(static_cast<int>(u * BUSY_LEVELS + 0.5), static_cast<int>(BUSY_LEVELS));
+				if(px > 0 && level == runLevel)
+					continue;
+			}
+
+			if(px > 0 && runLevel > 0)
+			{
+				int shade = 230 - runLevel * 150 / BUSY_LEVELS;
+				painter.fillRect(QRectF(area.left() + runStart, top, px - runStart, height),
+					QColor(shade, shade, 255));
+			}
+			runStart = px;
+			runLevel = level;
+		}
+	}
+
+	void paintBars(QPainter& painter, const QRect& area, size_t first, size_t last,
+		double top, double height, bool labels)
+	{
+		double pxPerTime = area.width() / (t1 - t0);
+		for(size_t i = first; i < last; ++i)
+		{
+			const GanttIndex::Bar& b = index.bar(i);
+			QRectF r(area.left() + (b.start - t0) * pxPerTime, top,
+				std::max((b.end - b.start) * pxPerTime, 1.0), height);
+
+			// kolejne zadania co zloty kat na kole barw
+			QColor color = QColor::fromHsv((b.job * 137) % 360, 120, 235);
+			painter.fillRect(r, color);
+			if(r.width() >= MIN_BAR_WIDTH + 1)
+			{
+				painter.setPen(color.darker(150));
+				painter.drawRect(r);
+			}
+			if(labels && r.width() >= MIN_LABEL_WIDTH)
+			{
+				painter.setPen(Qt::black);
+				painter.drawText(r, Qt::AlignCenter, QString::number(b.job + 1));
+			}
+		}
+	}
+
+	virtual void wheelEvent(QWheelEvent* e)
+	{
+		QRect area = plotArea();
+		double f = e->delta() > 0 ? 0.8 : 1.25;
+		if(e->modifiers() & Qt::ControlModifier)
+		{
+			double m = m0 + (e->pos().y() - area.top()) * (m1 - m0) / area.height();
+			m0 = m - (m - m0) * f;
+			m1 = m + (m1 - m) * f;
+		}
+		else
+		{
+			double t = t0 + (e->pos().x() - area.left()) * (t1 - t0) / area.width();
+			t0 = t - (t - t0) * f;
+			t1 = t + (t1 - t) * f;
+		}
+		clampView();
+		update();
+		e->accept();
+	}
+
+	virtual void mousePressEvent(QMouseEvent* e)
+	{
+		if(e->button() == Qt::LeftButton)
+		{
+			dragging = true;
+			dragPos = e->pos();
+		}
+	}
+
+	virtual void mouseMoveEvent(QMouseEvent* e)
+	{
+		if(!dragging)
+			return;
+
+		QRect area = plotArea();
+		double dt = (e->pos().x() - dragPos.x()) * (t1 - t0) / area.width();
+		double dm = (e->pos().y() - dragPos.y()) * (m1 - m0) / area.height();
+		t0 -= dt; t1 -= dt;
+		m0 -= dm; m1 -= dm;
+		dragPos = e->pos();
+		clampView();
+		update();
+	}
+
+	virtual void mouseReleaseEvent(QMouseEvent* e)
+	{
+		if(e->button() == Qt::LeftButton)
+			dragging = false;
+	}
+
+	virtual void mouseDoubleClickEvent(QMouseEvent*)
+	{
+		resetView();
+		update();
+	}
+
+	virtual bool event(QEvent* e)
+	{
+		if(e->type() != QEvent::ToolTip)
+			return QWidget::event(e);
+
+		QHelpEvent* help = static_cast<QHelpEvent*>(e);
+		QRect area = plotArea();
+		if(index.size() > 0 && area.contains(help->pos()))
+		{
+			core::uint32 m = static_cast<core::uint32>(m0 + (help->pos().y() - area.top()) * (m1 - m0) / area.height());
+			double t = t0 + (help->pos().x() - area.left()) * (t1 - t0) / area.width();
+			// pasek pod kursorem z tolerancja jednego piksela
+			double tol = (t1 - t0) / area.width();
+			size_t first, last;
+			if(m < index.numMachines())
+			{
+				index.visible(m, t - tol, t + tol, first, last);
+				if(first < last)
+				{
+					const GanttIndex::Bar& b = index.bar(first);
+					QToolTip::showText(help->globalPos(), QString("Job %1, operation %2, M%3: %4 - %5")
+						.arg(b.job + 1).arg(b.op + 1).arg(m + 1).arg(b.start).arg(b.end), this);
+					return true;
+				}
+			}
+		}
+		QToolTip::hideText();
+		e->ignore();
+		return true;
+	}
+
+private:
+	GanttIndex index;
+	// widoczny przedzial czasu i wierszy (ulamkowe - przesuwanie jest plynne)
+	double t0, t1;
+	double m0, m1;
+	bool fullView;
+	bool dragging;
+	QPoint dragPos;
+
+	// Widok w granicach harmonogramu, najmniej jedna jednostka czasu i jeden wiersz
+	void clampView()
+	{
+		double tMax = std::max<double>(index.makespan(), 1.0);
+		double mMax = std::max<double>(index.numMachines(), 1.0);
+		clampRange(t0, t1, 1.0, tMax);
+		clampRange(m0, m1, 1.0, mMax);
+		fullView = t0 <= 0.0 && t1 >= tMax && m0 <= 0.0 && m1 >= mMax;
+	}
+
+	static void clampRange(double& a, double& b, double minSpan, double maxEnd)
+	{
+		double span = std::min(std::max(b - a, minSpan), maxEnd);
+		if(a < 0.0)
+			a = 0.0;
+		if(a + span > maxEnd)
+			a = maxEnd - span;
+		b = a + span;
+	}
+};
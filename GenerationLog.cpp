@@ -0,0 +1,55 @@
+#include "GenerationLog.h"
+
+using namespace core;
+
+// -------------------------------------------------------------------------
+GenerationLog::GenerationLog(size_t capacity)
+: records(std::max<size_t>(capacity, 1)), numAppended(0), spill(0)
+{
+}
+// -------------------------------------------------------------------------
+GenerationLog::~GenerationLog()
+{
+	setSpill(0);
+}
+// -------------------------------------------------------------------------
+void GenerationLog::clear()
+{
+	numAppended = 0;
+}
+// -------------------------------------------------------------------------
+void GenerationLog::append(const GenerationRecord& r)
+{
+	records[static_cast<size_t>(numAppended % records.size())] = r;
+	++numAppended;
+
+	if(spill)
+	{
+		fprintf(spill, "%u,%u,%u,%.3f,%.3f,%u\n", r.generation, r.minObjective,
+			r.maxObjective, r.average, r.stdDeviation, r.stagnation);
+	}
+}
+// -------------------------------------------------------------------------
+bool GenerationLog::setSpill(const char* filename)
+{
+	if(spill)
+	{
+		fclose(spill);
+		spill = 0;
+	}
+	if(!filename)
+		return true;
+
+	spill = fopen(filename, "w");
+	if(!spill)
+	{
+		fprintf(stderr, "Can't open %s for writing\n", filename);
+		return false;
+	}
+
+	// zapis duzymi blokami, nie co rekord
+	setvbuf(spill, 0, _IOFBF, 1 << 16);
+	fputs("generation,min,max,avg,stddev,stagnation\n", spill);
+	return true;
+}
+// -------------------------------------------------------------------------
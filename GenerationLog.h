@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdio>
+#include <algorithm>
+
+#include "core/Prerequisites.h"
+
+// Stan populacji po pokoleniu
+struct GenerationRecord
+{
+	core::uint32 generation;
+	core::uint32 minObjective;
+	core::uint32 maxObjective;
+	core::uint32 stagnation; // pokolenia bez poprawy
+	float average;
+	float stdDeviation;
+};
+
+// * Dziennik pokolen o stalej pojemnosci: bufor cykliczny rekordow binarnych,
+//   najstarsze sa nadpisywane. Rekordy maja numer bezwzgledny (od clear),
+//   wiec widok moze sie do nich odwolywac, dopoki nie wypadna z bufora.
+//   Opcjonalnie kazdy rekord trafia tez do pliku CSV (pelna historia na dysku,
+//   w pamieci tylko ostatnie 'capacity').
+class GenerationLog
+{
+public:
+	explicit GenerationLog(size_t capacity = 1 << 16);
+	~GenerationLog();
+
+	void clear();
+	void append(const GenerationRecord& r);
+
+	// Zapis do pliku CSV "generation,min,max,avg,stddev,stagnation" od tej chwili;
+	// 0 zamyka plik
+	bool setSpill(const char* filename);
+
+	size_t capacity() const { return records.size(); }
+	size_t size() const { return static_cast<size_t>(std::min<core::uint64>(numAppended, records.size())); }
+	// Liczba rekordow dopisanych od clear; numer bezwzgledny najstarszego to total() - size()
+	core::uint64 total() const { return numAppended; }
+	core::uint64 firstIndex() const { return numAppended - size(); }
+
+	// Rekord o numerze bezwzglednym; 0 gdy juz wypadl z bufora (lub jeszcze go nie ma)
+	const GenerationRecord* find(core::uint64 index) const
+	{
+		if(index >= numAppended || index < firstIndex())
+			return 0;
+		return &records[static_cast<size_t>(index % records.size())];
+	}
+
+private:
+	std::vector<GenerationRecord> records;
+	core::uint64 numAppended;
+	FILE* spill;
+
+	GenerationLog(const GenerationLog&);
+	GenerationLog& operator=(const GenerationLog&);
+};
+
+#if defined(EVO_QT_SUPPORT)
+#include <QAbstractListModel>
+#include <QString>
+
+// * Model listy nad GenerationLog - widok (QListView z jednakowa wysokoscia
+//   wierszy) pyta tylko o widoczne wiersze, wiec tekst powstaje wylacznie dla
+//   nich. Wiersze sa dopasowywane do dziennika w sync(), nie przy kazdym pokoleniu.
+class GenerationLogModel : public QAbstractListModel
+{
+public:
+	GenerationLogModel(const GenerationLog& log, QObject* parent = 0)
+		: QAbstractListModel(parent), log(log), base(0), rows(0)
+	{
+	}
+
+	virtual int rowCount(const QModelIndex& parent = QModelIndex()) const
+	{
+		return parent.isValid() ? 0 : rows;
+	}
+
+	virtual QVariant data(const QModelIndex& index, int role) const
+	{
+		if(role != Qt::DisplayRole || !index.isValid())
+			return QVariant();
+
+		// wiersz nadpisany od ostatniego sync - pusty do nastepnego
+		const GenerationRecord* r = log.find(base + index.row());
+		if(!r)
+			return QVariant();
+
+		return QString("Generation: %1\t %2/%3/%4/%5 [min/max/avg/stddev], without improvements: %6")
+			.arg(r->generation)
+			.arg(r->minObjective)
+			.arg(r->maxObjective)
+			.arg(r->average, 0, 'f', 3)
+			.arg(r->stdDeviation, 0, 'f', 3)
+			.arg(r->stagnation);
+	}
+
+	// Usuwa wiersze ktore wypadly z dziennika i dodaje nowe
+	void sync()
+	{
+		core::uint64 first = log.firstIndex();
+		core::uint64 end = log.total();
+
+		// po clear albo gdy od ostatniego razu wymienil sie caly bufor
+		if(end < base + rows || first >= base + rows)
+		{
+			beginResetModel();
+			base = first;
+			rows = static_cast<int>(end - first);
+			endResetModel();
+			return;
+		}
+
+		if(first > base)
+		{
+			int dropped = static_cast<int>(first - base);
+			beginRemoveRows(QModelIndex(), 0, dropped - 1);
+			base = first;
+			rows -= dropped;
+			endRemoveRows();
+		}
+
+		int added = static_cast<int>(end - (base + rows));
+		if(added > 0)
+		{
+			beginInsertRows(QModelIndex(), rows, rows + added - 1);
+			rows += added;
+			endInsertRows();
+		}
+	}
+
+private:
+	const GenerationLog& log;
+	// numer bezwzgledny rekordu w wierszu 0
+	core::uint64 base;
+	int rows;
+};
+#endif
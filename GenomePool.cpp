@@ -0,0 +1,117 @@
+#include <new>
+#include <cstdlib>
+
+#include "Evo.h"
+#include "GenomePool.h"
+
+#if defined(_WIN32)
+#	include <malloc.h>
+#else
+#	include <sys/mman.h>
+#endif
+
+using namespace core;
+
+namespace
+{
+	inline size_t alignUp(size_t size, size_t alignment)
+	{
+		return (size + alignment - 1) & ~(alignment - 1);
+	}
+
+	// 2 MB - typowy rozmiar duzej strony na x86
+	const size_t HUGE_PAGE = 2 * 1024 * 1024;
+}
+
+// -------------------------------------------------------------------------
+GenomePool::GenomePool()
+: memory(0), slotSize(0), allocSize(0), count(0), allocKind(AK_NONE)
+{
+}
+// -------------------------------------------------------------------------
+GenomePool::~GenomePool()
+{
+	destroy();
+}
+// -------------------------------------------------------------------------
+void GenomePool::create(uint32 count, uint32 numGenes, uint32 geneBytes, uint32 numMachines,
+	uint32 numJobs, const uint32* rowOffsets, bool withSequence, bool hugePages)
+{
+	destroy();
+
+	size_t headerSize = alignUp(sizeof(Genome), CACHE_LINE);
+	slotSize = headerSize + alignUp(Genome::storageBytes(numGenes, geneBytes, numMachines, numJobs, withSequence), CACHE_LINE);
+	allocSize = slotSize * count;
+
+	if(allocSize == 0)
+		return;
+
+#if defined(__linux__) && defined(MAP_HUGETLB)
+	if(hugePages)
+	{
+		size_t hugeSize = alignUp(allocSize, HUGE_PAGE);
+		void* ptr = mmap(0, hugeSize, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if(ptr != MAP_FAILED)
+		{
+			memory = static_cast<char*>(ptr);
+			allocSize = hugeSize;
+			allocKind = AK_MMAP_HUGE;
+		}
+	}
+#endif
+
+	if(!memory)
+	{
+#if defined(_WIN32)
+		memory = static_cast<char*>(_aligned_malloc(allocSize, CACHE_LINE));
+#else
+		void* ptr = 0;
+		// przy duzych stronach wyrownanie do 2 MB pozwala jadru uzyc THP
+		size_t alignment = hugePages ? HUGE_PAGE : static_cast<size_t>(CACHE_LINE);
+		if(posix_memalign(&ptr, alignment, allocSize) == 0)
+			memory = static_cast<char*>(ptr);
+#	if defined(__linux__) && defined(MADV_HUGEPAGE)
+		if(memory && hugePages)
+			madvise(memory, allocSize, MADV_HUGEPAGE);
+#	endif
+#endif
+		if(!memory)
+			throw std::bad_alloc();
+		allocKind = AK_ALIGNED;
+	}
+
+	this->count = count;
+	for(uint32 i = 0; i < count; ++i)
+	{
+		char* slot = memory + i * slotSize;
+		new (slot) Genome(slot + headerSize, numGenes, geneBytes, numMachines,
+			numJobs, rowOffsets, withSequence);
+	}
+}
+// -------------------------------------------------------------------------
+void GenomePool::destroy()
+{
+	if(!memory)
+		return;
+
+	// Genome ma trywialny destruktor - wystarczy zwolnic pamiec
+
+#if defined(_WIN32)
+	_aligned_free(memory);
+#else
+#	if defined(__linux__) && defined(MAP_HUGETLB)
+	if(allocKind == AK_MMAP_HUGE)
+		munmap(memory, allocSize);
+	else
+#	endif
+		free(memory);
+#endif
+
+	memory = 0;
+	slotSize = 0;
+	allocSize = 0;
+	count = 0;
+	allocKind = AK_NONE;
+}
+// -------------------------------------------------------------------------
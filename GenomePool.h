@@ -0,0 +1,47 @@
+#pragma once
+
+#include "core/Prerequisites.h"
+
+struct Genome;
+
+// * Wszystkie genomy jednego przebiegu w jednym bloku pamieci.
+//   Slot = naglowek Genome + geny (z indeksem maszyn i sekwencja), kazdy
+//   wyrownany do linii cache'u, sloty leza jeden za drugim.
+class GenomePool
+{
+public:
+	GenomePool();
+	~GenomePool();
+
+	// Tworzy 'count' genomow po 'numGenes' genow o rozmiarze 'geneBytes' z indeksem
+	// 'numMachines' maszyn i 'numJobs' zadan, ew. z sekwencja operacji (poprzednia
+	// zawartosc jest niszczona). hugePages - proba uzycia duzych stron (Linux),
+	// w razie niepowodzenia zwykle strony
+	void create(core::uint32 count, core::uint32 numGenes, core::uint32 geneBytes,
+		core::uint32 numMachines, core::uint32 numJobs, const core::uint32* rowOffsets,
+		bool withSequence, bool hugePages);
+	void destroy();
+
+	Genome* get(core::uint32 i) const
+	{
+		assert(i < count);
+		return reinterpret_cast<Genome*>(memory + i * slotSize);
+	}
+
+	core::uint32 size() const { return count; }
+	size_t bytes() const { return allocSize; }
+	bool usesHugePages() const { return allocKind == AK_MMAP_HUGE; }
+
+private:
+	enum { CACHE_LINE = 64 };
+	enum EAllocKind { AK_NONE, AK_ALIGNED, AK_MMAP_HUGE };
+
+	char* memory;
+	size_t slotSize;
+	size_t allocSize;
+	core::uint32 count;
+	EAllocKind allocKind;
+
+	GenomePool(const GenomePool&);
+	GenomePool& operator=(const GenomePool&);
+};
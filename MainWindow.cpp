@@ -4,7 +4,7 @@
 
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
-    ui(new Ui::MainWindow), loaded(false)
+    ui(new Ui::MainWindow), running(false), stopRequested(false), loaded(false)
 {
     ui->setupUi(this);
 
@@ -55,6 +55,15 @@ MainWindow::MainWindow(QWidget *parent) :
 		d_zoomer[1]->setEnabled(true);
 	}
 
+	// Stala pamiec, widok formatuje tylko widoczne wiersze
+	genLogModel = new GenerationLogModel(genLog, this);
+	ui->generationView->setModel(genLogModel);
+	ui->generationView->setUniformItemSizes(true);
+
+	d_gantt = new GanttView(ui->ganttWidget);
+	d_gantt->resize(661, 511);
+	d_gantt->show();
+
     setDefaultValues();
     setValidators();
     connectSignalSlot();
@@ -77,6 +86,14 @@ void MainWindow::changeEvent(QEvent *e)
     }
 }
 
+void MainWindow::closeEvent(QCloseEvent *e)
+{
+	// petla przebiegu konczy sie przy najblizszej obsludze zdarzen
+	if(running)
+		stopRequested = true;
+	QMainWindow::closeEvent(e);
+}
+
 void MainWindow::connectSignalSlot()
 {
     // actions
@@ -179,10 +196,16 @@ void MainWindow::readProblemActionHandler()
 
 void MainWindow::startAlgorithmActionHandler()
 {
-	if(!loaded)
+	if(!loaded || running)
 		return;
 
 	ui->logBrowser->clear();
+	genLog.clear();
+	genLogModel->sync();
+#if defined(EVO_GENERATION_LOG_FILE)
+	// pelna historia na dysku, w pamieci tylko ostatnie pokolenia
+	genLog.setSpill("generations.csv");
+#endif
 
 	enum EFinishCondition
 	{
@@ -226,9 +249,44 @@ void MainWindow::startAlgorithmActionHandler()
 	problem.setOperatorProbability(pRowColumn);
 	problem.setGenitor(genitor);
 	problem.setSSParameters(nTempPopSize, replaceCoeff, nPopSize);
+	// najlepszy harmonogram dla wykresu Gantta w trakcie przebiegu
+	problem.setAnytime(true);
+#if defined(EVO_ADAPTIVE_OPERATORS)
+	// wspolczynniki z formularza sa punktem startowym adaptacji
+	problem.setAdaptiveOperators(true);
+	problem.setOperatorLog("operator_rates.txt");
+#endif
+#if defined(EVO_LOCAL_SEARCH)
+	problem.setLocalSearch(10, 50);
+#endif
+#if defined(EVO_BOUNDED_DECODING)
+	problem.setBoundedDecoding(true);
+#endif
+#if defined(EVO_SCREENING)
+	problem.setScreening(1.05f, 20);
+#endif
 	problem.generateRandomSolutions(nPopSize);
+#if defined(EVO_PERF_COUNTERS)
+	problem.setPerfCounters(true);
+#endif
 	problem.setTournamentParameters(tourGroupSize, allowDuplicates);
 
+	// Warunek zakonczenia sprawdza silnik (zawsze rowniez dolne ograniczenie)
+	Problem::StopConditions stop;
+	if(fc == FC_WITHOUT_IMPROV)
+		stop.stagnation = condExit;
+	else
+		stop.maxGenerations = condExit;
+	problem.setStopConditions(stop);
+#if defined(EVO_CHECKPOINT)
+	// Wznowienie przerwanego przebiegu (razem z jego ustawieniami) i obraz stanu co 100 pokolen
+	if(QFile::exists("checkpoint.evo") && problem.loadCheckpoint("checkpoint.evo"))
+		ui->logBrowser->append(QString("Resumed from checkpoint.evo at generation %1 "
+			"(settings restored from the checkpoint, form values other than the stop condition are ignored)\n")
+			.arg(problem.getGeneration()));
+	problem.setCheckpoint("checkpoint.evo", 100);
+#endif
+
 	QString popDsc;
 	problem.getPopulationDesc(popDsc);
 
@@ -238,51 +296,43 @@ void MainWindow::startAlgorithmActionHandler()
 	// wypisz najlepsze rozwiazanie losowe (tylko w celach porownawczych)
 	problem.outputToMatlab("solution_init.m", 0);
 
-	QVector<double> vmax;
-	QVector<double> vmin;
-	QVector<double> vavg;
-	QVector<double> xaxis;
-
-	// Inicjalizacja wektora danych wykresu
-	{
-		vmax.reserve(condExit);
-		vmin.reserve(condExit);
-		vavg.reserve(condExit);
-		xaxis.reserve(condExit);
-
-		vmax.push_back(static_cast<double>(problem.maxObjective));
-		vmin.push_back(static_cast<double>(problem.minObjective));
-		vavg.push_back(static_cast<double>(problem.average));
-		xaxis.push_back(static_cast<double>(0));
-	}
+	// Historia wykresu (stala pamiec, rysowana z poziomu szczegolowosci dla widoku)
+	d_plot->clearSeries();
+	d_plot->appendSample(static_cast<double>(problem.getGeneration()),
+		static_cast<double>(problem.maxObjective),
+		static_cast<double>(problem.minObjective),
+		static_cast<double>(problem.average));
 
 	// Do skalowania osi Y
-	double vmax_max = vmax[0];
-	double vmin_min = vmin[0];
+	double vmax_max = static_cast<double>(problem.maxObjective);
+	double vmin_min = static_cast<double>(problem.minObjective);
 
 	// Dane iteracji
-	core::uint32 nIter = 0;
-	core::uint32 nGenWithoutImprovements = 0;
-	core::uint32 nLastBestGenObjScore = problem.minObjective;
+	core::uint32 nIter = problem.getGeneration();
 
 	d_panner->setEnabled(false);
 	d_zoomer[0]->setEnabled(false);
 	d_zoomer[1]->setEnabled(false);
 
+	d_gantt->clearSchedule();
+	core::uint32 ganttObjective = 0;
+	refreshGantt(problem, ganttObjective);
+
+	// Miedzy pokoleniami okno obsluguje zdarzenia (zakladki, wykres Gantta),
+	// ponowny start i wczytanie problemu sa do konca przebiegu wylaczone
+	running = true;
+	stopRequested = false;
+	startAlgorithmAction->setEnabled(false);
+	readProblemAction->setEnabled(false);
+	QTime eventTimer;
+	eventTimer.start();
+
 	// Glowna petla
 	for(; ; ++nIter )
 	{
 		// Warunek zakonczenia dzialania algorytmu
-		if(fc == FC_WITHOUT_IMPROV)
-		{
-			if(nGenWithoutImprovements >= condExit)
-				break;
-		}
-		else
-		{
-			if(nIter >= condExit)
-				break;
-		}
+		if(problem.shouldStop() || stopRequested)
+			break;
 
 		problem.nextGen();
 
@@ -290,61 +340,113 @@ void MainWindow::startAlgorithmActionHandler()
 		if(nIter % 100 == 0)
 		{
 			d_plot->setAxis(0.0f, static_cast<float>(nIter), vmin_min, vmax_max);
-			d_plot->cMaxVal->setSamples(xaxis, vmax);
-			d_plot->cMinVal->setSamples(xaxis, vmin);
-			d_plot->cAvgVal->setSamples(xaxis, vavg);
 			d_plot->replot();
+
+			genLogModel->sync();
+			ui->generationView->scrollToBottom();
 		}
 
 		// Zbieranie info o aktualnej populacji
 		{
-			QString iterDesc;
-			QTextStream strm(&iterDesc);
-			//QTextStream strm(stderr);
-			strm.setRealNumberNotation(QTextStream::FixedNotation);
-			strm.setRealNumberPrecision(3);
-			strm << "Generation: " << nIter << "\t " << problem.minObjective << "/" 
-				 << problem.maxObjective << "/" << problem.average << "/" << problem.stdDeviation << "[min/max/avg/stddev]\n";
-			strm << "Generations without improvements: " << nGenWithoutImprovements << "\n";
+			GenerationRecord rec;
+			rec.generation = nIter;
+			rec.minObjective = problem.minObjective;
+			rec.maxObjective = problem.maxObjective;
+			rec.stagnation = problem.getStagnation();
+			rec.average = problem.average;
+			rec.stdDeviation = problem.stdDeviation;
 
 			// aktualizuj loga
-			ui->logBrowser->append(iterDesc);
-
-			vmax.push_back(static_cast<double>(problem.maxObjective));
-			vmin.push_back(static_cast<double>(problem.minObjective));
-			vavg.push_back(static_cast<double>(problem.average));
-			xaxis.push_back(static_cast<double>(nIter));
-
-			vmax_max = std::max(vmax[nIter], vmax_max);
-			vmin_min = std::min(vmin[nIter], vmin_min);
-
-			// NOTE: bez GENITOR'a moga byc pogorszenia
-			if(problem.minObjective >= nLastBestGenObjScore)
-			{
-				++nGenWithoutImprovements;
-			}
-			else
-			{
-				nGenWithoutImprovements = 0;
-				nLastBestGenObjScore = problem.minObjective;
-			}
+			genLog.append(rec);
+
+			d_plot->appendSample(static_cast<double>(nIter),
+				static_cast<double>(problem.maxObjective),
+				static_cast<double>(problem.minObjective),
+				static_cast<double>(problem.average));
+
+			vmax_max = std::max(static_cast<double>(problem.maxObjective), vmax_max);
+			vmin_min = std::min(static_cast<double>(problem.minObjective), vmin_min);
+		}
+
+		// Co ok. 250 ms - niezaleznie od dlugosci pokolenia
+		if(eventTimer.elapsed() >= 250)
+		{
+			refreshGantt(problem, ganttObjective);
+			QCoreApplication::processEvents();
+			eventTimer.restart();
 		}
 	}
 
+	running = false;
+	startAlgorithmAction->setEnabled(true);
+	readProblemAction->setEnabled(true);
+	refreshGantt(problem, ganttObjective);
+
+	genLogModel->sync();
+	ui->generationView->scrollToBottom();
+#if defined(EVO_GENERATION_LOG_FILE)
+	genLog.setSpill(0);
+#endif
+
 	// Wyswietlenie w formie "verbose" wyniku koncowego algorytmu
 	popDsc.clear();
 	problem.getPopulationDesc(popDsc);
+	popDsc += QString("Stopped: %1 after %2 generations, %3 s\n")
+		.arg(Problem::stopReasonName(problem.getStopReason()))
+		.arg(problem.getGeneration())
+		.arg(problem.getElapsedTime(), 0, 'f', 3);
 	// aktualizuj loga
 	ui->logBrowser->append(popDsc);
 
+#if defined(EVO_PROFILE)
+	// Rozklad czasu na poszczegolne fazy algorytmu
+	popDsc.clear();
+	problem.getProfileDesc(popDsc);
+	ui->logBrowser->append(popDsc);
+	problem.showProfile();
+#endif
+
+#if defined(EVO_BOUNDED_DECODING)
+	ui->logBrowser->append(QString("Bounded decoding: %1 of %2 decodes stopped at the cutoff\n")
+		.arg(problem.getRejectedCount()).arg(problem.getDecodeCount()));
+#endif
+
+#if defined(EVO_LOCAL_SEARCH)
+	// Koszt i skutecznosc lokalnego przeszukiwania
+	const Problem::LocalSearchStats& ls = problem.getLocalSearchStats();
+	ui->logBrowser->append(QString("Local search: %1 genomes, %2 improved, %3 moves, %4 decodes, %5 s\n")
+		.arg(ls.calls).arg(ls.improved).arg(ls.moves).arg(ls.evaluations).arg(ls.seconds, 0, 'f', 3));
+#endif
+
+	// Skutecznosc wstepnej oceny potomkow (gdy wlaczona)
+	if(problem.getScreeningStats().passed + problem.getScreeningStats().screenedOut > 0)
+	{
+		popDsc.clear();
+		problem.getScreeningDesc(popDsc);
+		ui->logBrowser->append(popDsc);
+	}
+
+#if defined(EVO_PERF_COUNTERS)
+	// Liczniki sprzetowe (lub informacja o ich braku)
+	popDsc.clear();
+	problem.getPerfDesc(popDsc);
+	ui->logBrowser->append(popDsc);
+#endif
+
+#if defined(EVO_TRACE)
+	// Przebieg watkow do obejrzenia w Perfetto / chrome://tracing
+	problem.writeTrace("trace.json");
+#endif
+
 	// Wypisanie najlepszego wyniku do pliku matlaba
 	problem.outputToMatlab("solution_best.m", 0);
+	problem.outputSchedule("solution_best.csv", ScheduleWriter::SF_CSV);
+	// i kompromisow miedzy celami
+	if(fm == Problem::FM_NSGA2)
+		problem.outputPareto("solution_pareto.txt");
 
 	// Narysowanie ostatecznego wykresu
 	d_plot->setAxis(0.0f, static_cast<float>(nIter), vmin_min, vmax_max);
-	d_plot->cMaxVal->setSamples(xaxis, vmax);
-	d_plot->cMinVal->setSamples(xaxis, vmin);
-	d_plot->cAvgVal->setSamples(xaxis, vavg);
 	d_plot->replot();
 
 	d_zoomer[0]->setZoomBase();
@@ -355,6 +457,18 @@ void MainWindow::startAlgorithmActionHandler()
 	d_zoomer[1]->setEnabled(true);
 }
 
+void MainWindow::refreshGantt(Problem& problem, core::uint32& shownObjective)
+{
+	// kopia harmonogramu tylko po poprawie najlepszego
+	if(problem.getBestObjective() == shownObjective)
+		return;
+	if(problem.getBestSchedule(ganttTable))
+	{
+		d_gantt->setSchedule(ganttTable, problem.getNumMachines());
+		shownObjective = ganttTable.makespan;
+	}
+}
+
 void MainWindow::quitActionHandler()
 {
     this->close();
@@ -3,6 +3,10 @@
 
 #include <QtGui>
 #include "Plot.h"
+#include "GenerationLog.h"
+#include "GanttView.h"
+
+class Problem;
 
 namespace Ui {
     class MainWindow;
@@ -16,6 +20,7 @@ public:
 
 protected:
     void changeEvent(QEvent *e);
+	void closeEvent(QCloseEvent *e);
 
 private slots:
     void aboutActionHandler();
@@ -31,6 +36,7 @@ private:
     void setDefaultValues();
     void setValidators();
     void setProblemViewData(const QString &data);
+	void refreshGantt(Problem& problem, core::uint32& shownObjective);
 
     Ui::MainWindow *ui;
     QMenuBar *menuBar;
@@ -48,6 +54,19 @@ private:
 	Zoomer* d_zoomer[2];
 	QwtPlotPanner* d_panner;
 
+	// Dziennik pokolen ostatniego przebiegu i jego model dla generationView
+	GenerationLog genLog;
+	GenerationLogModel* genLogModel;
+
+	// Najlepszy harmonogram przebiegu (odswiezany w trakcie)
+	GanttView* d_gantt;
+	ScheduleTable ganttTable;
+
+	// Przebieg trwa (okno obsluguje zdarzenia miedzy pokoleniami)
+	bool running;
+	// Zamkniecie okna w trakcie przebiegu
+	bool stopRequested;
+
     QTextBrowser *reportBrowser;
 	QString fName;
 	bool loaded;
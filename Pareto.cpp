@@ -0,0 +1,222 @@
+#include <omp.h>
+#include <algorithm>
+#include <limits>
+
+#include "Evo.h"
+#include "Pareto.h"
+
+using namespace core;
+
+namespace
+{
+	// assignFronts zaklada dokladnie trzy cele (sortowanie + schodki w dwoch wymiarach)
+	typedef char AssertThreeObjectives[Genome::NUM_OBJECTIVES == 3 ? 1 : -1];
+
+	// Porzadek leksykograficzny wektorow celow
+	bool lexicographicLess(const ParetoSorter::Entry& a, const ParetoSorter::Entry& b)
+	{
+		for(uint32 k = 0; k < Genome::NUM_OBJECTIVES; ++k)
+		{
+			if(a.objectives[k] != b.objectives[k])
+				return a.objectives[k] < b.objectives[k];
+		}
+		return a.index < b.index;
+	}
+
+	// Porzadek pozycji wg jednego celu (remisy wg pozycji - wynik deterministyczny)
+	struct ObjectiveLess
+	{
+		const uint32* values;
+
+		ObjectiveLess(const uint32* values) : values(values) {}
+
+		bool operator()(uint32 a, uint32 b) const
+		{
+			return values[a] != values[b] ? values[a] < values[b] : a < b;
+		}
+	};
+}
+
+// -------------------------------------------------------------------------
+ParetoSorter::ParetoSorter()
+: numFronts(0), count(0)
+{
+}
+// -------------------------------------------------------------------------
+uint32 ParetoSorter::rank(Genome* const* pop, uint32 n)
+{
+	count = n;
+	sizes.clear();
+	if(n == 0)
+		return 0;
+
+	sortLexicographic(pop);
+	assignFronts();
+	crowdingDistance(pop);
+
+	for(uint32 f = 0; f < numFronts; ++f)
+	{
+		const std::vector<uint32>& front = fronts[f];
+		sizes.push_back(static_cast<uint32>(front.size()));
+		for(size_t i = 0; i < front.size(); ++i)
+			pop[order[front[i]]]->rank = f;
+	}
+	return numFronts;
+}
+// -------------------------------------------------------------------------
+bool ParetoSorter::frontDominates(uint32 f, uint32 o1, uint32 o2) const
+{
+	// ostatni schodek z celem 1 <= o1 ma najmniejszy cel 2 w tym zakresie
+	const std::vector<Step>& s = stairs[f];
+	Step key = { o1, 0 };
+	std::vector<Step>::const_iterator it = std::upper_bound(s.begin(), s.end(), key);
+	if(it == s.begin())
+		return false;
+	--it;
+	return it->o2 <= o2;
+}
+// -------------------------------------------------------------------------
+void ParetoSorter::sortLexicographic(Genome* const* pop)
+{
+	// kopia celow obok indeksu - sortowanie bez odwolan do genomow
+	entries.resize(count);
+	for(uint32 i = 0; i < count; ++i)
+	{
+		memcpy(entries[i].objectives, pop[i]->objectives, sizeof(entries[i].objectives));
+		entries[i].index = i;
+	}
+
+	// Kazdy watek sortuje swoj kawalek, potem kawalki sa scalane parami
+	int numChunks = std::min(omp_get_max_threads(), static_cast<int>(count / CHUNK_SIZE) + 1);
+	std::vector<uint32> bounds(numChunks + 1);
+	for(int c = 0; c <= numChunks; ++c)
+		bounds[c] = static_cast<uint32>(static_cast<uint64>(count) * c / numChunks);
+
+	#pragma omp parallel for
+	for(int c = 0; c < numChunks; ++c)
+		std::sort(entries.begin() + bounds[c], entries.begin() + bounds[c + 1], lexicographicLess);
+
+	for(int step = 1; step < numChunks; step *= 2)
+	{
+		#pragma omp parallel for
+		for(int c = 0; c < numChunks - step; c += 2 * step)
+		{
+			int last = std::min(c + 2 * step, numChunks);
+			std::inplace_merge(entries.begin() + bounds[c], entries.begin() + bounds[c + step],
+				entries.begin() + bounds[last], lexicographicLess);
+		}
+	}
+
+	// cele w kolejnosci leksykograficznej - osobne tablice dla kazdego celu
+	order.resize(count);
+	obj.resize(Genome::NUM_OBJECTIVES * count);
+	for(uint32 i = 0; i < count; ++i)
+	{
+		order[i] = entries[i].index;
+		for(uint32 k = 0; k < Genome::NUM_OBJECTIVES; ++k)
+			obj[k * count + i] = entries[i].objectives[k];
+	}
+}
+// -------------------------------------------------------------------------
+void ParetoSorter::assignFronts()
+{
+	for(uint32 f = 0; f < numFronts; ++f)
+	{
+		fronts[f].clear();
+		stairs[f].clear();
+	}
+	numFronts = 0;
+
+	const uint32* o0 = objective(0);
+	const uint32* o1 = objective(1);
+	const uint32* o2 = objective(2);
+
+	uint32 f = 0;
+	for(uint32 i = 0; i < count; ++i)
+	{
+		// Osobniki przed 'i' nie sa gorsze w celu 0, wiec dominuje go kazdy z nich
+		// nie gorszy w celach 1 i 2 (poza identycznym wektorem - ten trafia do
+		// frontu poprzednika). Jesli front k nie dominuje 'i', to zaden wyzszy
+		// tez nie (dominator z k+1 bylby zdominowany przez kogos z k)
+		bool duplicate = i > 0 && o0[i] == o0[i - 1] && o1[i] == o1[i - 1] && o2[i] == o2[i - 1];
+		if(!duplicate)
+		{
+			uint32 lo = 0, hi = numFronts;
+			while(lo < hi)
+			{
+				uint32 mid = (lo + hi) / 2;
+				if(frontDominates(mid, o1[i], o2[i]))
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			f = lo;
+		}
+
+		if(f == numFronts)
+		{
+			if(fronts.size() <= f)
+			{
+				fronts.resize(f + 1);
+				stairs.resize(f + 1);
+			}
+			++numFronts;
+		}
+		fronts[f].push_back(i);
+
+		// dopisanie do schodkow: usuwa schodki ktore nowy punkt przykrywa
+		if(!duplicate && !frontDominates(f, o1[i], o2[i]))
+		{
+			std::vector<Step>& s = stairs[f];
+			Step step = { o1[i], o2[i] };
+			std::vector<Step>::iterator first = std::lower_bound(s.begin(), s.end(), step);
+			std::vector<Step>::iterator last = first;
+			while(last != s.end() && last->o2 >= step.o2)
+				++last;
+			s.insert(s.erase(first, last), step);
+		}
+	}
+}
+// -------------------------------------------------------------------------
+void ParetoSorter::crowdingDistance(Genome* const* pop)
+{
+	const float infinity = std::numeric_limits<float>::infinity();
+	dist.resize(Genome::NUM_OBJECTIVES * count);
+
+	// Niezalezne zadania: (front, cel). Front jest juz posortowany wg pierwszego
+	// celu (porzadek leksykograficzny), pozostale cele wymagaja sortowania
+	int32 numTasks = static_cast<int32>(numFronts * Genome::NUM_OBJECTIVES);
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for(int32 t = 0; t < numTasks; ++t)
+	{
+		uint32 f = t / Genome::NUM_OBJECTIVES;
+		uint32 k = t % Genome::NUM_OBJECTIVES;
+		const uint32* values = objective(k);
+		float* d = &dist[k * count];
+
+		std::vector<uint32> sorted(fronts[f]);
+		if(k > 0)
+			std::sort(sorted.begin(), sorted.end(), ObjectiveLess(values));
+
+		size_t size = sorted.size();
+		d[sorted[0]] = d[sorted[size - 1]] = infinity;
+
+		float range = static_cast<float>(values[sorted[size - 1]] - values[sorted[0]]);
+		for(size_t i = 1; i + 1 < size; ++i)
+		{
+			d[sorted[i]] = range > 0.0f
+				? (values[sorted[i + 1]] - values[sorted[i - 1]]) / range : 0.0f;
+		}
+	}
+
+	#pragma omp parallel for
+	for(int32 i = 0; i < static_cast<int32>(count); ++i)
+	{
+		float c = 0.0f;
+		for(uint32 k = 0; k < Genome::NUM_OBJECTIVES; ++k)
+			c += dist[k * count + i];
+		pop[order[i]]->crowding = c;
+	}
+}
+// -------------------------------------------------------------------------
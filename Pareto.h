@@ -0,0 +1,71 @@
+#pragma once
+
+#include "core/Prerequisites.h"
+
+struct Genome;
+
+// * Szybkie sortowanie niezdominowane i odleglosc zatloczenia (NSGA-II) dla
+//   trzech celow. Osobniki sa porzadkowane leksykograficznie po wektorze celow
+//   (rownolegle) - wtedy kazdy dominujacy lezy przed zdominowanym i wystarczy
+//   sprawdzic pozostale dwa cele. Kazdy front trzyma "schodki" niezdominowanych
+//   par (cel 1, cel 2), wiec pytanie "czy front k dominuje osobnika" kosztuje
+//   O(log n), a front osobnika (najnizszy bez dominatora) jest wyszukiwany
+//   binarnie - lacznie O(N log N log F) zamiast O(N^2). Odleglosc zatloczenia
+//   liczona rownolegle dla par (front, cel).
+//   Wynik trafia do Genome::rank (0 - front niezdominowany) i Genome::crowding.
+class ParetoSorter
+{
+public:
+	ParetoSorter();
+
+	// Przydziela fronty i odleglosc zatloczenia 'n' osobnikom.
+	// Zwraca liczbe frontow
+	core::uint32 rank(Genome* const* pop, core::uint32 n);
+
+	// Liczba osobnikow w kolejnych frontach (po ostatnim rank)
+	const std::vector<core::uint32>& frontSizes() const { return sizes; }
+
+	struct Entry
+	{
+		core::uint32 objectives[3];
+		core::uint32 index;
+	};
+
+	// Schodek: cel 1 i najmniejszy cel 2 wsrod osobnikow frontu z celem 1 <= o1
+	struct Step
+	{
+		core::uint32 o1;
+		core::uint32 o2;
+
+		bool operator<(const Step& other) const { return o1 < other.o1; }
+	};
+
+private:
+	// osobnicy w porzadku leksykograficznym, cele w ukladzie SoA (obj[k][pozycja])
+	std::vector<Entry> entries;
+	std::vector<core::uint32> order;
+	std::vector<core::uint32> obj;
+	// pozycje osobnikow kolejnych frontow (rosnaco) i ich schodki
+	// (posortowane wg celu 1, cel 2 maleje)
+	std::vector<std::vector<core::uint32> > fronts;
+	std::vector<std::vector<Step> > stairs;
+	core::uint32 numFronts;
+	std::vector<core::uint32> sizes;
+	// skladowe odleglosci zatloczenia dla kazdego celu (dist[k][pozycja])
+	std::vector<float> dist;
+	core::uint32 count;
+
+	// najmniejszy kawalek sortowany przez jeden watek
+	enum { CHUNK_SIZE = 1024 };
+
+	const core::uint32* objective(core::uint32 k) const { return &obj[k * count]; }
+	// Czy front 'f' ma osobnika nie gorszego w celach 1 i 2
+	bool frontDominates(core::uint32 f, core::uint32 o1, core::uint32 o2) const;
+
+	void sortLexicographic(Genome* const* pop);
+	void assignFronts();
+	void crowdingDistance(Genome* const* pop);
+
+	ParetoSorter(const ParetoSorter&);
+	ParetoSorter& operator=(const ParetoSorter&);
+};
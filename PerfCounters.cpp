@@ -0,0 +1,174 @@
+#include <omp.h>
+
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+#	include <linux/perf_event.h>
+#	include <sys/syscall.h>
+#	include <sys/ioctl.h>
+#	include <unistd.h>
+#endif
+
+using namespace core;
+
+#if defined(__linux__)
+namespace
+{
+	// glibc nie udostepnia wrappera
+	int perfEventOpen(perf_event_attr* attr, pid_t pid, int cpu, int groupFd, unsigned long flags)
+	{
+		return static_cast<int>(syscall(__NR_perf_event_open, attr, pid, cpu, groupFd, flags));
+	}
+
+	int openEvent(EPerfEvent e)
+	{
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		switch(e)
+		{
+		case PE_CYCLES:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_CPU_CYCLES;
+			break;
+		case PE_INSTRUCTIONS:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+			break;
+		case PE_L1D_MISSES:
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_L1D |
+				(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+				(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			break;
+		case PE_LLC_MISSES:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_CACHE_MISSES;
+			break;
+		case PE_BRANCH_MISSES:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+			break;
+		default:
+			return -1;
+		}
+
+		// pid == 0, cpu == -1: tylko wolajacy watek, na dowolnym procesorze
+		int fd = perfEventOpen(&attr, 0, -1, -1, 0);
+		if(fd >= 0)
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		return fd;
+	}
+}
+#endif
+
+// -------------------------------------------------------------------------
+PerfCounters::PerfCounters()
+: numThreads(0), available(false)
+{
+	for(int e = 0; e < PE_COUNT; ++e)
+		eventAvailable[e] = false;
+}
+// -------------------------------------------------------------------------
+PerfCounters::~PerfCounters()
+{
+	close();
+}
+// -------------------------------------------------------------------------
+bool PerfCounters::open()
+{
+	close();
+
+#if defined(__linux__)
+	numThreads = omp_get_max_threads();
+	fds.assign(numThreads * PE_COUNT, -1);
+
+	// Liczniki z pid == 0 licza tylko watek ktory je otworzyl,
+	// dlatego kazdy watek puli OpenMP otwiera wlasny zestaw
+	#pragma omp parallel num_threads(numThreads)
+	{
+		int t = omp_get_thread_num();
+		for(int e = 0; e < PE_COUNT; ++e)
+			fds[t * PE_COUNT + e] = openEvent(static_cast<EPerfEvent>(e));
+	}
+
+	// zdarzenie jest dostepne tylko jesli udalo sie je otworzyc dla wszystkich watkow
+	for(int e = 0; e < PE_COUNT; ++e)
+	{
+		eventAvailable[e] = true;
+		for(int t = 0; t < numThreads; ++t)
+		{
+			if(fds[t * PE_COUNT + e] < 0)
+				eventAvailable[e] = false;
+		}
+		available = available || eventAvailable[e];
+	}
+#endif
+
+	if(!available)
+		close();
+	return available;
+}
+// -------------------------------------------------------------------------
+void PerfCounters::close()
+{
+#if defined(__linux__)
+	for(size_t i = 0; i < fds.size(); ++i)
+	{
+		if(fds[i] >= 0)
+			::close(fds[i]);
+	}
+#endif
+	fds.clear();
+	available = false;
+	for(int e = 0; e < PE_COUNT; ++e)
+		eventAvailable[e] = false;
+}
+// -------------------------------------------------------------------------
+void PerfCounters::read(uint64 values[PE_COUNT]) const
+{
+	for(int e = 0; e < PE_COUNT; ++e)
+		values[e] = 0;
+
+#if defined(__linux__)
+	for(int t = 0; t < numThreads; ++t)
+	{
+		for(int e = 0; e < PE_COUNT; ++e)
+		{
+			if(!eventAvailable[e])
+				continue;
+
+			// wartosc, czas wlaczenia, czas faktycznego zliczania
+			uint64 buf[3];
+			if(::read(fds[t * PE_COUNT + e], buf, sizeof(buf)) != sizeof(buf))
+				continue;
+
+			if(buf[2] > 0 && buf[2] < buf[1])
+				buf[0] = static_cast<uint64>(static_cast<double>(buf[0]) * buf[1] / buf[2]);
+			values[e] += buf[0];
+		}
+	}
+#endif
+}
+// -------------------------------------------------------------------------
+const char* PerfCounters::eventName(EPerfEvent e)
+{
+	static const char* names[PE_COUNT] = {
+		"cycles", "instructions", "L1d-misses", "LLC-misses", "branch-misses"
+	};
+	return names[e];
+}
+// -------------------------------------------------------------------------
+const char* PerfCounters::phaseName(EPerfPhase p)
+{
+	static const char* names[PF_COUNT] = {
+		"preselect", "breed", "reinsert", "sort", "calcStats", "fitness", "localSearch"
+	};
+	return names[p];
+}
+// -------------------------------------------------------------------------
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "core/Prerequisites.h"
+
+// * Sprzetowe liczniki wydajnosci (Linux perf_event_open)
+enum EPerfEvent
+{
+	PE_CYCLES,
+	PE_INSTRUCTIONS,
+	PE_L1D_MISSES,
+	PE_LLC_MISSES,
+	PE_BRANCH_MISSES,
+	PE_COUNT
+};
+
+// * Fazy Problem::nextGen dla ktorych zbierane sa liczniki.
+//   PF_BREED to cala rownolegla petla tworzenia potomkow
+//   (selekcja, krzyzowanie, mutacja i dekodowanie).
+enum EPerfPhase
+{
+	PF_PRESELECT,
+	PF_BREED,
+	PF_REINSERT,
+	PF_SORT,
+	PF_STATS,
+	PF_FITNESS,
+	PF_LOCALSEARCH,
+	PF_COUNT
+};
+
+class PerfCounters
+{
+public:
+	PerfCounters();
+	~PerfCounters();
+
+	// Otwiera liczniki dla kazdego z watkow OpenMP. Zwraca false jesli
+	// zaden licznik nie jest dostepny (inny system, kontener, perf_event_paranoid)
+	bool open();
+	void close();
+
+	bool isAvailable() const { return available; }
+	bool isAvailable(EPerfEvent e) const { return eventAvailable[e]; }
+
+	// Biezace wartosci licznikow zsumowane po wszystkich watkach
+	// (przeskalowane, jesli jadro multipleksowalo liczniki)
+	void read(core::uint64 values[PE_COUNT]) const;
+
+	static const char* eventName(EPerfEvent e);
+	static const char* phaseName(EPerfPhase p);
+
+private:
+	std::vector<int> fds; // [watek * PE_COUNT + zdarzenie], -1 gdy niedostepne
+	int numThreads;
+	bool available;
+	bool eventAvailable[PE_COUNT];
+
+	PerfCounters(const PerfCounters&);
+	PerfCounters& operator=(const PerfCounters&);
+};
+
+// * Dopisuje przyrost licznikow w czasie zycia zakresu do podanej fazy
+class PerfScope
+{
+public:
+	PerfScope(const PerfCounters& perf, core::uint64* phaseValues)
+		: perf(perf), phaseValues(phaseValues)
+	{
+		if(perf.isAvailable())
+			perf.read(start);
+	}
+
+	~PerfScope()
+	{
+		if(!perf.isAvailable())
+			return;
+
+		core::uint64 stop[PE_COUNT];
+		perf.read(stop);
+		for(int e = 0; e < PE_COUNT; ++e)
+		{
+			// po skalowaniu (multipleksowanie) wartosci moga nie byc monotoniczne
+			if(stop[e] > start[e])
+				phaseValues[e] += stop[e] - start[e];
+		}
+	}
+
+private:
+	const PerfCounters& perf;
+	core::uint64* phaseValues;
+	core::uint64 start[PE_COUNT];
+};
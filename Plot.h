@@ -11,6 +11,8 @@
 #include <qwt_plot_panner.h>
 #include <qwt_plot_renderer.h>
 
+#include "SeriesLod.h"
+
 class Zoomer: public QwtPlotZoomer
 {
 public:
@@ -30,12 +32,51 @@ public:
 	  }
 };
 
+// * Dane krzywej z historii SeriesLod. Qwt podaje widoczny prostokat przy
+//   kazdej zmianie osi (setAxis, zoom, przesuwanie) - wtedy wybierany jest
+//   poziom szczegolowosci, wiec replot kosztuje O(szerokosc wykresu),
+//   a nie O(liczba pokolen)
+class LodSeriesData : public QwtSeriesData<QPointF>
+{
+public:
+	LodSeriesData() : maxPoints(2048) {}
+
+	SeriesLod& series() { return lod; }
+	// Budzet punktow - ok. dwa na piksel szerokosci
+	void setMaxPoints(size_t n) { maxPoints = n; }
+
+	virtual size_t size() const { return points.size(); }
+	virtual QPointF sample(size_t i) const { return QPointF(points[i].x, points[i].y); }
+
+	virtual QRectF boundingRect() const
+	{
+		// pusty prostokat (ujemny rozmiar) - brak danych
+		if(lod.count() == 0)
+			return QRectF(1.0, 1.0, -2.0, -2.0);
+		return QRectF(lod.minX(), lod.minY(), lod.maxX() - lod.minX(), lod.maxY() - lod.minY());
+	}
+
+	virtual void setRectOfInterest(const QRectF& rect)
+	{
+		lod.select(rect.left(), rect.right(), maxPoints, points);
+	}
+
+private:
+	SeriesLod lod;
+	size_t maxPoints;
+	std::vector<SeriesLod::Point> points;
+};
+
 class Plot : public QwtPlot
 {
 public:
 	QwtPlotCurve* cMaxVal;
 	QwtPlotCurve* cMinVal;
 	QwtPlotCurve* cAvgVal;
+	// wlasnoscia krzywych
+	LodSeriesData* dMaxVal;
+	LodSeriesData* dMinVal;
+	LodSeriesData* dAvgVal;
 
 	Plot(QWidget* parent = NULL)
 		: QwtPlot(parent)
@@ -76,6 +117,13 @@ public:
 		cAvgVal->setPen(QPen(Qt::blue));
 		cAvgVal->attach(this);
 
+		dMaxVal = new LodSeriesData();
+		dMinVal = new LodSeriesData();
+		dAvgVal = new LodSeriesData();
+		cMaxVal->setData(dMaxVal);
+		cMinVal->setData(dMinVal);
+		cAvgVal->setData(dAvgVal);
+
 		// Insert markers
 
 		//  ...a horizontal line at y = 0...
@@ -101,5 +149,29 @@ public:
 	{
 		setAxisScale(xBottom, xmin, xmax);
 		setAxisScale(yLeft, ymin, ymax);
+
+		// rowniez gdy zakres sie nie zmienil, a doszly nowe probki
+		QRectF rect(xmin, ymin, xmax - xmin, ymax - ymin);
+		size_t maxPoints = std::max(2 * canvas()->width(), 200);
+		LodSeriesData* data[] = { dMaxVal, dMinVal, dAvgVal };
+		for(int i = 0; i < 3; ++i)
+		{
+			data[i]->setMaxPoints(maxPoints);
+			data[i]->setRectOfInterest(rect);
+		}
+	}
+
+	void clearSeries()
+	{
+		dMaxVal->series().clear();
+		dMinVal->series().clear();
+		dAvgVal->series().clear();
+	}
+
+	void appendSample(double x, double maxVal, double minVal, double avgVal)
+	{
+		dMaxVal->series().append(x, maxVal);
+		dMinVal->series().append(x, minVal);
+		dAvgVal->series().append(x, avgVal);
 	}
 };
\ No newline at end of file
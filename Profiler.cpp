@@ -0,0 +1,77 @@
+#include <omp.h>
+
+#include "Profiler.h"
+
+using namespace core;
+
+// -------------------------------------------------------------------------
+Profiler::Profiler()
+: slots(0), slotsMem(0), numSlots(omp_get_max_threads())
+{
+	// pamiec recznie wyrownana do linii cache'u
+	slotsMem = new char[numSlots * sizeof(ThreadCounters) + CACHE_LINE];
+	size_t addr = reinterpret_cast<size_t>(slotsMem);
+	addr = (addr + CACHE_LINE - 1) & ~static_cast<size_t>(CACHE_LINE - 1);
+	slots = reinterpret_cast<ThreadCounters*>(addr);
+
+	reset();
+}
+// -------------------------------------------------------------------------
+Profiler::~Profiler()
+{
+	delete [] slotsMem;
+}
+// -------------------------------------------------------------------------
+void Profiler::reset()
+{
+	memset(slots, 0, numSlots * sizeof(ThreadCounters));
+	memset(genCycles, 0, sizeof(genCycles));
+	memset(genCount, 0, sizeof(genCount));
+	memset(totCycles, 0, sizeof(totCycles));
+	memset(totCount, 0, sizeof(totCount));
+	nGens = 0;
+}
+// -------------------------------------------------------------------------
+void Profiler::merge()
+{
+	memset(genCycles, 0, sizeof(genCycles));
+	memset(genCount, 0, sizeof(genCount));
+
+	for(int t = 0; t < numSlots; ++t)
+	{
+		for(int p = 0; p < PP_COUNT; ++p)
+		{
+			genCycles[p] += slots[t].cycles[p];
+			genCount[p] += slots[t].count[p];
+		}
+	}
+	memset(slots, 0, numSlots * sizeof(ThreadCounters));
+
+	for(int p = 0; p < PP_COUNT; ++p)
+	{
+		totCycles[p] += genCycles[p];
+		totCount[p] += genCount[p];
+	}
+	++nGens;
+}
+// -------------------------------------------------------------------------
+void Profiler::add(EProfilePhase phase, uint64 cycles)
+{
+	int t = omp_get_thread_num();
+	// watki spoza puli (np. zagniezdzony parallel) trafiaja do ostatniego slotu
+	if(t >= numSlots)
+		t = numSlots - 1;
+
+	slots[t].cycles[phase] += cycles;
+	slots[t].count[phase]++;
+}
+// -------------------------------------------------------------------------
+const char* Profiler::phaseName(EProfilePhase phase)
+{
+	static const char* names[PP_COUNT] = {
+		"preselect", "select", "crossover", "mutate", "decode",
+		"reinsert", "sort", "calcStats", "fitness", "localSearch"
+	};
+	return names[phase];
+}
+// -------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "core/Base.h"
+
+// * Fazy generowania nowego pokolenia mierzone przez profiler
+enum EProfilePhase
+{
+	PP_PRESELECT,
+	PP_SELECT,
+	PP_CROSSOVER,
+	PP_MUTATE,
+	PP_DECODE,
+	PP_REINSERT,
+	PP_SORT,
+	PP_STATS,
+	PP_FITNESS,
+	PP_LOCALSEARCH,
+	PP_COUNT
+};
+
+// * Liczniki cykli (rdtsc) dla poszczegolnych faz algorytmu.
+//   Kazdy watek OpenMP pisze tylko do swojego slotu (wyrownanego do linii
+//   cache'u), sloty sa sumowane w merge() na koniec kazdego pokolenia.
+class Profiler
+{
+public:
+	Profiler();
+	~Profiler();
+
+	// Zeruje wszystkie liczniki (rowniez sumaryczne)
+	void reset();
+	// Przenosi liczniki watkow do statystyk ostatniego pokolenia i calego przebiegu
+	void merge();
+
+	void add(EProfilePhase phase, core::uint64 cycles);
+
+	core::uint64 generationCycles(EProfilePhase phase) const { return genCycles[phase]; }
+	core::uint64 generationCount(EProfilePhase phase) const { return genCount[phase]; }
+	core::uint64 totalCycles(EProfilePhase phase) const { return totCycles[phase]; }
+	core::uint64 totalCount(EProfilePhase phase) const { return totCount[phase]; }
+	core::uint32 numGenerations() const { return nGens; }
+
+	static const char* phaseName(EProfilePhase phase);
+
+	static core::uint64 tsc()
+	{
+		core::uint32 lo, hi;
+		core::getrdtsc(&lo, &hi);
+		return (static_cast<core::uint64>(hi) << 32) | lo;
+	}
+
+private:
+	enum { CACHE_LINE = 64 };
+
+	struct ThreadCounters
+	{
+		core::uint64 cycles[PP_COUNT];
+		core::uint64 count[PP_COUNT];
+		// dopelnienie do wielokrotnosci linii cache'u (brak false sharing)
+		char pad[CACHE_LINE - (2 * PP_COUNT * sizeof(core::uint64)) % CACHE_LINE];
+	};
+
+	ThreadCounters* slots;
+	char* slotsMem;
+	int numSlots;
+
+	core::uint64 genCycles[PP_COUNT];
+	core::uint64 genCount[PP_COUNT];
+	core::uint64 totCycles[PP_COUNT];
+	core::uint64 totCount[PP_COUNT];
+	core::uint32 nGens;
+
+	Profiler(const Profiler&);
+	Profiler& operator=(const Profiler&);
+};
+
+// * Mierzy czas zycia zakresu i dopisuje go do podanej fazy
+class ProfileScope
+{
+public:
+	ProfileScope(Profiler& prof, EProfilePhase phase)
+		: prof(prof), phase(phase), start(Profiler::tsc()) {}
+	~ProfileScope() { prof.add(phase, Profiler::tsc() - start); }
+
+private:
+	Profiler& prof;
+	EProfilePhase phase;
+	core::uint64 start;
+};
+
+// Profilowanie wlaczane jest w czasie kompilacji (DEFINES += EVO_PROFILE),
+// bez niego makro nic nie generuje
+#if defined(EVO_PROFILE)
+#	define EVO_PROFILE_SCOPE(prof, phase) ProfileScope profileScope_(prof, phase)
+#else
+#	define EVO_PROFILE_SCOPE(prof, phase)
+#endif
@@ -0,0 +1,160 @@
+#include <cstdio>
+
+#include "ScheduleExport.h"
+
+using namespace core;
+
+namespace
+{
+	// Liczba dziesietnie od 'p', zwraca koniec
+	char* formatUInt(char* p, uint32 value)
+	{
+		char digits[10];
+		int n = 0;
+		do
+		{
+			digits[n++] = static_cast<char>('0' + value % 10);
+			value /= 10;
+		} while(value);
+
+		while(n)
+			*p++ = digits[--n];
+		return p;
+	}
+}
+
+// -------------------------------------------------------------------------
+ScheduleWriter::ScheduleWriter()
+: fp(0), ownsFile(false), format(SF_CSV), numSchedules(0), ok(false)
+{
+}
+// -------------------------------------------------------------------------
+ScheduleWriter::~ScheduleWriter()
+{
+	close();
+}
+// -------------------------------------------------------------------------
+bool ScheduleWriter::open(const char* filename, EFormat fmt,
+	uint32 numJobs, uint32 numMachines)
+{
+	close();
+
+	fp = fopen(filename, fmt == SF_BINARY ? "wb" : "w");
+	if(!fp)
+	{
+		fprintf(stderr, "Can't open %s for writing\n", filename);
+		return false;
+	}
+
+	ownsFile = true;
+	format = fmt;
+	writeHeader(numJobs, numMachines);
+	return true;
+}
+// -------------------------------------------------------------------------
+bool ScheduleWriter::open(FILE* stream, EFormat fmt, uint32 numJobs, uint32 numMachines)
+{
+	close();
+
+	fp = stream;
+	ownsFile = false;
+	format = fmt;
+	writeHeader(numJobs, numMachines);
+	return fp != 0;
+}
+// -------------------------------------------------------------------------
+void ScheduleWriter::writeHeader(uint32 numJobs, uint32 numMachines)
+{
+	numSchedules = 0;
+	ok = true;
+	buffer.clear();
+	buffer.reserve(BUFFER_SIZE + 64);
+
+	if(format == SF_BINARY)
+	{
+		uint32 header[3] = { BINARY_VERSION, numJobs, numMachines };
+		append("EVOSCHED", 8);
+		append(header, sizeof(header));
+	}
+	else
+	{
+		static const char header[] = "schedule,job,op,machine,start,end\n";
+		append(header, sizeof(header) - 1);
+	}
+}
+// -------------------------------------------------------------------------
+bool ScheduleWriter::write(const ScheduleTable& table)
+{
+	if(!fp)
+		return false;
+
+	uint32 rows = static_cast<uint32>(table.rows());
+
+	if(format == SF_BINARY)
+	{
+		uint32 header[2] = { table.makespan, rows };
+		append(header, sizeof(header));
+		if(rows > 0)
+		{
+			append(&table.job[0], rows * sizeof(uint32));
+			append(&table.op[0], rows * sizeof(uint32));
+			append(&table.machine[0], rows * sizeof(uint32));
+			append(&table.start[0], rows * sizeof(uint32));
+			append(&table.end[0], rows * sizeof(uint32));
+		}
+	}
+	else
+	{
+		// 6 liczb po najwyzej 10 cyfr + separatory
+		char line[72];
+		for(uint32 i = 0; i < rows; ++i)
+		{
+			char* p = formatUInt(line, numSchedules);
+			*p++ = ',';
+			p = formatUInt(p, table.job[i]);
+			*p++ = ',';
+			p = formatUInt(p, table.op[i]);
+			*p++ = ',';
+			p = formatUInt(p, table.machine[i]);
+			*p++ = ',';
+			p = formatUInt(p, table.start[i]);
+			*p++ = ',';
+			p = formatUInt(p, table.end[i]);
+			*p++ = '\n';
+			append(line, p - line);
+		}
+	}
+
+	++numSchedules;
+	return ok;
+}
+// -------------------------------------------------------------------------
+bool ScheduleWriter::close()
+{
+	if(!fp)
+		return ok;
+
+	flushBuffer();
+	if(ownsFile)
+		ok = fclose(fp) == 0 && ok;
+	else
+		ok = fflush(fp) == 0 && ok;
+	fp = 0;
+	return ok;
+}
+// -------------------------------------------------------------------------
+void ScheduleWriter::append(const void* data, size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	buffer.insert(buffer.end(), bytes, bytes + size);
+	if(buffer.size() >= BUFFER_SIZE)
+		flushBuffer();
+}
+// -------------------------------------------------------------------------
+void ScheduleWriter::flushBuffer()
+{
+	if(!buffer.empty() && fwrite(&buffer[0], 1, buffer.size(), fp) != buffer.size())
+		ok = false;
+	buffer.clear();
+}
+// -------------------------------------------------------------------------
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdio>
+
+#include "core/Prerequisites.h"
+
+// * Harmonogram w ukladzie kolumnowym: jeden wiersz na operacje
+//   (w kolejnosci zadan i operacji), kazda kolumna w osobnej tablicy
+struct ScheduleTable
+{
+	std::vector<core::uint32> job;
+	std::vector<core::uint32> op; // numer operacji w zadaniu
+	std::vector<core::uint32> machine;
+	std::vector<core::uint32> start;
+	std::vector<core::uint32> end;
+	core::uint32 makespan;
+
+	ScheduleTable() : makespan(0) {}
+
+	void resize(size_t rows)
+	{
+		job.resize(rows);
+		op.resize(rows);
+		machine.resize(rows);
+		start.resize(rows);
+		end.resize(rows);
+	}
+	size_t rows() const { return job.size(); }
+
+	void swap(ScheduleTable& other)
+	{
+		job.swap(other.job);
+		op.swap(other.op);
+		machine.swap(other.machine);
+		start.swap(other.start);
+		end.swap(other.end);
+		std::swap(makespan, other.makespan);
+	}
+};
+
+// * Strumieniowy zapis harmonogramow do jednego pliku (np. k najlepszych
+//   rozwiazan) - kazdy harmonogram jest zapisywany od razu, w pamieci jest
+//   tylko bufor wyjsciowy.
+//
+//   SF_CSV: naglowek "schedule,job,op,machine,start,end", potem wiersz na
+//   operacje (schedule - numer harmonogramu w pliku, od 0).
+//
+//   SF_BINARY (porzadek bajtow maszyny, wszystkie pola uint32):
+//     "EVOSCHED" version numJobs numMachines
+//     dla kazdego harmonogramu: makespan rows, potem kolumny
+//     job[rows] op[rows] machine[rows] start[rows] end[rows]
+//   Plik konczy sie po ostatnim harmonogramie.
+class ScheduleWriter
+{
+public:
+	enum EFormat
+	{
+		SF_CSV,
+		SF_BINARY
+	};
+
+	ScheduleWriter();
+	~ScheduleWriter();
+
+	bool open(const char* filename, EFormat format,
+		core::uint32 numJobs, core::uint32 numMachines);
+	// Zapis do otwartego strumienia (np. gniazda) - close go nie zamyka
+	bool open(FILE* stream, EFormat format, core::uint32 numJobs, core::uint32 numMachines);
+	bool write(const ScheduleTable& table);
+	// Zwraca false gdy ktorykolwiek zapis sie nie powiodl
+	bool close();
+
+	core::uint32 count() const { return numSchedules; }
+
+private:
+	enum { BUFFER_SIZE = 1 << 16, BINARY_VERSION = 1 };
+
+	FILE* fp;
+	bool ownsFile;
+	EFormat format;
+	std::vector<char> buffer;
+	core::uint32 numSchedules;
+	bool ok;
+
+	void writeHeader(core::uint32 numJobs, core::uint32 numMachines);
+	void append(const void* data, size_t size);
+	void flushBuffer();
+
+	ScheduleWriter(const ScheduleWriter&);
+	ScheduleWriter& operator=(const ScheduleWriter&);
+};
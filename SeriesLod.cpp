@@ -0,0 +1,151 @@
+#include <algorithm>
+
+#include "SeriesLod.h"
+
+using namespace core;
+
+// -------------------------------------------------------------------------
+SeriesLod::SeriesLod(uint32 capacity, uint32 numLevels)
+: capacity(std::max(capacity, 2U)), levels(std::max(numLevels, 1U))
+{
+	clear();
+}
+// -------------------------------------------------------------------------
+void SeriesLod::clear()
+{
+	for(size_t k = 0; k < levels.size(); ++k)
+	{
+		// pamiec zostaje - kolejny przebieg nie alokuje
+		levels[k].ring.clear();
+		levels[k].head = 0;
+		levels[k].pushed = 0;
+		levels[k].open.count = 0;
+	}
+	numSamples = 0;
+	xFirst = xLast = yMin = yMax = 0.0;
+}
+// -------------------------------------------------------------------------
+void SeriesLod::addSample(Bucket& b, double x, double y)
+{
+	if(b.count == 0)
+	{
+		b.xFirst = b.xMin = b.xMax = x;
+		b.yMin = b.yMax = y;
+	}
+	else if(y < b.yMin)
+	{
+		b.xMin = x;
+		b.yMin = y;
+	}
+	else if(y > b.yMax)
+	{
+		b.xMax = x;
+		b.yMax = y;
+	}
+	b.xLast = x;
+	++b.count;
+}
+// -------------------------------------------------------------------------
+void SeriesLod::append(double x, double y)
+{
+	if(numSamples == 0)
+	{
+		xFirst = x;
+		yMin = yMax = y;
+	}
+	xLast = x;
+	yMin = std::min(yMin, y);
+	yMax = std::max(yMax, y);
+	++numSamples;
+
+	for(size_t k = 0; k < levels.size(); ++k)
+	{
+		Level& level = levels[k];
+		addSample(level.open, x, y);
+		if(level.open.count < (1ULL << k))
+			continue;
+
+		// kubelek pelny - do bufora, najstarszy wypada
+		if(level.ring.size() < capacity)
+		{
+			level.ring.push_back(level.open);
+		}
+		else
+		{
+			level.ring[level.head] = level.open;
+			level.head = (level.head + 1) % capacity;
+		}
+		++level.pushed;
+		level.open.count = 0;
+	}
+}
+// -------------------------------------------------------------------------
+uint32 SeriesLod::lowerBound(const Level& level, double x) const
+{
+	uint32 lo = 0;
+	uint32 hi = static_cast<uint32>(level.ring.size());
+	while(lo < hi)
+	{
+		uint32 mid = (lo + hi) / 2;
+		if(at(level, mid).xLast < x)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+// -------------------------------------------------------------------------
+void SeriesLod::emit(const Bucket& b, std::vector<Point>& out)
+{
+	Point first = { b.xMin, b.yMin };
+	Point second = { b.xMax, b.yMax };
+	if(b.xMax < b.xMin)
+		std::swap(first, second);
+
+	out.push_back(first);
+	if(b.count > 1 && second.x != first.x)
+		out.push_back(second);
+}
+// -------------------------------------------------------------------------
+void SeriesLod::select(double x0, double x1, size_t maxPoints, std::vector<Point>& out) const
+{
+	out.clear();
+	if(numSamples == 0)
+		return;
+
+	size_t maxBuckets = std::max<size_t>(maxPoints / 2, 1);
+
+	// * Step 1: najdrobniejszy poziom ktory ma jeszcze poczatek przedzialu
+	//   i miesci sie w budzecie (najgrubszy - zawsze, w najgorszym razie przyciety)
+	size_t k = 0;
+	uint32 first = 0, last = 0;
+	for(; k < levels.size(); ++k)
+	{
+		const Level& level = levels[k];
+		uint32 size = static_cast<uint32>(level.ring.size());
+		bool complete = level.pushed <= capacity;
+		if(size > 0 && !complete && at(level, 0).xFirst > x0)
+			continue;
+
+		// jeden kubelek przed i po przedziale - linia dochodzi do krawedzi
+		first = lowerBound(level, x0);
+		last = lowerBound(level, x1);
+		first = first > 0 ? first - 1 : 0;
+		last = std::min(last + 1, size);
+
+		if(last - first + 1 <= maxBuckets || k + 1 == levels.size())
+			break;
+	}
+
+	// * Step 2: kubelki zamkniete i otwarty (najnowsze probki) tego poziomu
+	const Level& level = levels[k];
+	if(last - first > maxBuckets)
+		first = last - static_cast<uint32>(maxBuckets);
+
+	out.reserve(2 * (last - first + 1));
+	for(uint32 i = first; i < last; ++i)
+		emit(at(level, i), out);
+	if(level.open.count > 0 && level.open.xFirst <= x1)
+		emit(level.open, out);
+}
+// -------------------------------------------------------------------------
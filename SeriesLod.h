@@ -0,0 +1,76 @@
+#pragma once
+
+#include "core/Prerequisites.h"
+
+// * Historia przebiegu y(x) (x rosnace, np. numer pokolenia) w piramidzie
+//   poziomow szczegolowosci: kubelek poziomu k obejmuje 2^k kolejnych probek
+//   i pamieta ich minimum i maksimum (z polozeniem), wiec zadne ekstremum nie
+//   znika przy zmniejszaniu rozdzielczosci. Kazdy poziom trzyma najwyzej
+//   'capacity' ostatnich kubelkow (bufor cykliczny) - pamiec jest stala
+//   niezaleznie od dlugosci przebiegu, a najgrubsze poziomy obejmuja cala historie.
+//
+//   select wybiera najdrobniejszy poziom ktory pokrywa zadany przedzial
+//   i miesci sie w budzecie punktow - koszt rysowania zalezy od szerokosci
+//   wykresu, nie od liczby pokolen. Dopisanie probki - O(liczba poziomow).
+class SeriesLod
+{
+public:
+	struct Point
+	{
+		double x;
+		double y;
+	};
+
+	SeriesLod(core::uint32 capacity = 1024, core::uint32 numLevels = 26);
+
+	void clear();
+	void append(double x, double y);
+
+	// Punkty (po dwa na kubelek: minimum i maksimum w kolejnosci x) pokrywajace
+	// [x0, x1] razem z sasiednimi kubelkami, najwyzej ok. maxPoints
+	void select(double x0, double x1, size_t maxPoints, std::vector<Point>& out) const;
+
+	// Liczba wszystkich dopisanych probek i ich zakres
+	core::uint64 count() const { return numSamples; }
+	double minX() const { return xFirst; }
+	double maxX() const { return xLast; }
+	double minY() const { return yMin; }
+	double maxY() const { return yMax; }
+
+private:
+	struct Bucket
+	{
+		double xFirst;
+		double xLast;
+		double xMin;
+		double yMin;
+		double xMax;
+		double yMax;
+		core::uint32 count;
+	};
+
+	struct Level
+	{
+		// bufor cykliczny zamknietych kubelkow, najstarszy pod 'head'
+		std::vector<Bucket> ring;
+		core::uint32 head;
+		core::uint64 pushed;
+		// kubelek w trakcie wypelniania
+		Bucket open;
+	};
+
+	core::uint32 capacity;
+	std::vector<Level> levels;
+	core::uint64 numSamples;
+	double xFirst, xLast, yMin, yMax;
+
+	static void addSample(Bucket& b, double x, double y);
+	static void emit(const Bucket& b, std::vector<Point>& out);
+
+	const Bucket& at(const Level& level, core::uint32 i) const
+	{
+		return level.ring[(level.head + i) % level.ring.size()];
+	}
+	// Pierwszy kubelek poziomu konczacy sie w x lub pozniej
+	core::uint32 lowerBound(const Level& level, double x) const;
+};
@@ -0,0 +1,109 @@
+#include <omp.h>
+#include <cstdio>
+
+#include "Trace.h"
+
+using namespace core;
+
+// -------------------------------------------------------------------------
+Tracer::Tracer()
+: buffers(0), numBuffers(omp_get_max_threads()), capacity(0), startTime(omp_get_wtime())
+{
+}
+// -------------------------------------------------------------------------
+Tracer::~Tracer()
+{
+	release();
+}
+// -------------------------------------------------------------------------
+void Tracer::release()
+{
+	if(!buffers)
+		return;
+
+	for(int t = 0; t < numBuffers; ++t)
+		delete [] buffers[t].events;
+	delete [] buffers;
+	buffers = 0;
+}
+// -------------------------------------------------------------------------
+void Tracer::reset(uint32 capacityPerThread)
+{
+	if(!buffers || capacity != capacityPerThread)
+	{
+		release();
+
+		capacity = capacityPerThread;
+		buffers = new ThreadBuffer[numBuffers];
+		for(int t = 0; t < numBuffers; ++t)
+			buffers[t].events = new Event[capacity];
+	}
+
+	for(int t = 0; t < numBuffers; ++t)
+	{
+		buffers[t].size = 0;
+		buffers[t].dropped = 0;
+	}
+
+	startTime = omp_get_wtime();
+}
+// -------------------------------------------------------------------------
+void Tracer::record(const char* name, char ph)
+{
+	int t = omp_get_thread_num();
+	if(!buffers || t >= numBuffers)
+		return;
+
+	ThreadBuffer& buf = buffers[t];
+	if(buf.size >= capacity)
+	{
+		buf.dropped++;
+		return;
+	}
+
+	Event& e = buf.events[buf.size++];
+	e.name = name;
+	e.ts = (omp_get_wtime() - startTime) * 1e6; // w mikrosekundach
+	e.ph = ph;
+}
+// -------------------------------------------------------------------------
+uint32 Tracer::dropped() const
+{
+	uint32 n = 0;
+	for(int t = 0; buffers && t < numBuffers; ++t)
+		n += buffers[t].dropped;
+	return n;
+}
+// -------------------------------------------------------------------------
+bool Tracer::write(const char* filename) const
+{
+	FILE* fp = fopen(filename, "w");
+	if(!fp)
+		return false;
+
+	fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	bool first = true;
+	for(int t = 0; buffers && t < numBuffers; ++t)
+	{
+		const ThreadBuffer& buf = buffers[t];
+		if(buf.size == 0)
+			continue;
+
+		fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,"
+			"\"args\":{\"name\":\"omp thread %d\"}}", first ? "" : ",\n", t, t);
+		first = false;
+
+		for(uint32 i = 0; i < buf.size; ++i)
+		{
+			const Event& e = buf.events[i];
+			fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":0,\"tid\":%d}",
+				e.name, e.ph, e.ts, t);
+		}
+	}
+
+	fprintf(fp, "\n]}\n");
+	fclose(fp);
+	return true;
+}
+// -------------------------------------------------------------------------
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "core/Prerequisites.h"
+
+// * Zapis przebiegu watkow w formacie Chrome trace-event (chrome://tracing, Perfetto).
+//   Kazdy watek OpenMP ma wlasny, zaalokowany z gory bufor zdarzen - zapis
+//   nie wymaga zadnej synchronizacji. Po zapelnieniu bufora kolejne zdarzenia
+//   sa pomijane (i zliczane).
+class Tracer
+{
+public:
+	Tracer();
+	~Tracer();
+
+	// Czysci bufory i ustawia ich pojemnosc (w zdarzeniach na watek)
+	void reset(core::uint32 capacityPerThread = 1 << 20);
+
+	void begin(const char* name) { record(name, 'B'); }
+	void end(const char* name) { record(name, 'E'); }
+
+	// Liczba zdarzen ktore nie zmiescily sie w buforach
+	core::uint32 dropped() const;
+
+	// Zapisuje zebrane zdarzenia jako JSON
+	bool write(const char* filename) const;
+
+private:
+	struct Event
+	{
+		const char* name; // tylko literaly - nie kopiujemy napisow
+		double ts;
+		char ph;
+	};
+
+	enum { CACHE_LINE = 64 };
+
+	struct ThreadBuffer
+	{
+		Event* events;
+		core::uint32 size;
+		core::uint32 dropped;
+		char pad[CACHE_LINE - sizeof(Event*) - 2 * sizeof(core::uint32)];
+	};
+
+	ThreadBuffer* buffers;
+	int numBuffers;
+	core::uint32 capacity;
+	double startTime;
+
+	void record(const char* name, char ph);
+	void release();
+
+	Tracer(const Tracer&);
+	Tracer& operator=(const Tracer&);
+};
+
+class TraceScope
+{
+public:
+	TraceScope(Tracer& tracer, const char* name)
+		: tracer(tracer), name(name) { tracer.begin(name); }
+	~TraceScope() { tracer.end(name); }
+
+private:
+	Tracer& tracer;
+	const char* name;
+};
+
+// Sledzenie wlaczane jest w czasie kompilacji (DEFINES += EVO_TRACE),
+// bez niego makra nic nie generuja
+#if defined(EVO_TRACE)
+#	define EVO_TRACE_SCOPE(tracer, name) TraceScope traceScope_(tracer, name)
+#	define EVO_TRACE_BEGIN(tracer, name) (tracer).begin(name)
+#	define EVO_TRACE_END(tracer, name) (tracer).end(name)
+#else
+#	define EVO_TRACE_SCOPE(tracer, name)
+#	define EVO_TRACE_BEGIN(tracer, name)
+#	define EVO_TRACE_END(tracer, name)
+#endif
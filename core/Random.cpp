@@ -10,6 +10,9 @@ namespace core
 		virtual ~Random_pimpl() {}
 		virtual uint32 rand_impl() = 0;
 		virtual void srand_impl(uint32 seed) = 0;
+		// stan wewnetrzny jako ciag slow (dopisywany do 'state')
+		virtual void save_impl(std::vector<uint32>& state) const = 0;
+		virtual bool load_impl(const uint32* state, size_t size) = 0;
 	};
 
 	// Generator liniowy, implementacja wbudowanego rand()
@@ -22,6 +25,8 @@ namespace core
 
 		virtual uint32 rand_impl();
 		virtual void srand_impl(uint32 seed);
+		virtual void save_impl(std::vector<uint32>& state) const;
+		virtual bool load_impl(const uint32* state, size_t size);
 
 	private:
 		uint32 _a, _c;
@@ -37,6 +42,8 @@ namespace core
 
 		virtual uint32 rand_impl();
 		virtual void srand_impl(uint32 seed);
+		virtual void save_impl(std::vector<uint32>& state) const;
+		virtual bool load_impl(const uint32* state, size_t size);
 
 	private:
 		enum { N = 624 };
@@ -58,6 +65,8 @@ namespace core
 		virtual uint32 rand_impl();
 		virtual void srand_impl(uint32 seed);
 		virtual void srand_impl(uint32 a = 0, uint32 b = 0, uint32 c = 0, uint32* s = 0);
+		virtual void save_impl(std::vector<uint32>& state) const;
+		virtual bool load_impl(const uint32* state, size_t size);
 
 	private:
 		enum { RANDSIZL = 8 };
@@ -87,7 +96,7 @@ namespace core
 
 	// -------------------------------------------------------------------------
 	Random::Random()
-	: mpGenerator(0), a(0), b((uint32)0xFFFFFFFF)
+	: mpGenerator(0), type(GT_MERSENNE_TWISTER), a(0), b((uint32)0xFFFFFFFF)
 	{
 	}
 	// -------------------------------------------------------------------------
@@ -106,6 +115,7 @@ namespace core
 		if(mpGenerator)
 			delete mpGenerator;
 
+		this->type = type;
 		switch(type)
 		{
 		case GT_LINEAR:
@@ -128,6 +138,29 @@ namespace core
 		mpGenerator->srand_impl(seed);
 	}
 	// -------------------------------------------------------------------------
+	void Random::getState(std::vector<uint32>& state) const
+	{
+		state.clear();
+		if(!mpGenerator)
+			return;
+
+		state.push_back(static_cast<uint32>(type));
+		state.push_back(a);
+		state.push_back(b);
+		mpGenerator->save_impl(state);
+	}
+	// -------------------------------------------------------------------------
+	bool Random::setState(const std::vector<uint32>& state)
+	{
+		if(state.size() < 3 || state[0] > GT_ISAAC)
+			return false;
+
+		setGenerator(static_cast<EGeneratorType>(state[0]));
+		a = state[1];
+		b = state[2];
+		return mpGenerator->load_impl(&state[0] + 3, state.size() - 3);
+	}
+	// -------------------------------------------------------------------------
 	void Random::setBound(uint32 a, uint32 b)
 	{
 		this->a = a;
@@ -194,6 +227,23 @@ namespace core
 		//return rand();
 	}
 	// -------------------------------------------------------------------------
+	void LCGenerator::save_impl(std::vector<uint32>& state) const
+	{
+		state.push_back(_a);
+		state.push_back(_c);
+		state.push_back(seed);
+	}
+	// -------------------------------------------------------------------------
+	bool LCGenerator::load_impl(const uint32* state, size_t size)
+	{
+		if(size != 3)
+			return false;
+		_a = state[0];
+		_c = state[1];
+		seed = state[2];
+		return true;
+	}
+	// -------------------------------------------------------------------------
 	void MTGenerator::srand_impl(uint32 seed)
 	{
 		register uint32* s = state; // wskaznik na tablice
@@ -224,15 +274,32 @@ namespace core
 	{
 		if(idx == 0)
 			reload();
-		idx = (idx + 1) % N;
 
-		register uint32 y = state[idx-1];
+		// slowo odczytywane przed przesunieciem indeksu - inaczej po
+		// idx == N-1 czytane bylo state[-1]
+		register uint32 y = state[idx];
+		idx = (idx + 1) % N;
 		y ^= (y >> 11);
 		y ^= (y << 7) & 0x9d2c5680UL;
 		y ^= (y << 15) & 0xefc60000UL;
 		return (y ^ (y >> 18));
 	}
 	// -------------------------------------------------------------------------
+	void MTGenerator::save_impl(std::vector<uint32>& state) const
+	{
+		state.push_back(static_cast<uint32>(idx));
+		state.insert(state.end(), this->state, this->state + N);
+	}
+	// -------------------------------------------------------------------------
+	bool MTGenerator::load_impl(const uint32* state, size_t size)
+	{
+		if(size != N + 1 || state[0] >= N)
+			return false;
+		idx = static_cast<int>(state[0]);
+		memcpy(this->state, state + 1, N * sizeof(uint32));
+		return true;
+	}
+	// -------------------------------------------------------------------------
 	inline void ISAACGenerator::shuffle(uint32& a, uint32& b, uint32& c, uint32& d,
 		uint32& e, uint32& f, uint32& g, uint32& h)
 	{
@@ -280,6 +347,29 @@ namespace core
 		randinit();
 	}
 	// -------------------------------------------------------------------------
+	void ISAACGenerator::save_impl(std::vector<uint32>& state) const
+	{
+		state.push_back(ctx.randcnt);
+		state.insert(state.end(), ctx.randrsl, ctx.randrsl + N);
+		state.insert(state.end(), ctx.randmem, ctx.randmem + N);
+		state.push_back(ctx.randa);
+		state.push_back(ctx.randb);
+		state.push_back(ctx.randc);
+	}
+	// -------------------------------------------------------------------------
+	bool ISAACGenerator::load_impl(const uint32* state, size_t size)
+	{
+		if(size != 2 * N + 4 || state[0] == 0 || state[0] > N)
+			return false;
+		ctx.randcnt = state[0];
+		memcpy(ctx.randrsl, state + 1, N * sizeof(uint32));
+		memcpy(ctx.randmem, state + 1 + N, N * sizeof(uint32));
+		ctx.randa = state[1 + 2 * N];
+		ctx.randb = state[2 + 2 * N];
+		ctx.randc = state[3 + 2 * N];
+		return true;
+	}
+	// -------------------------------------------------------------------------
 	uint32 ISAACGenerator::rand_impl()
 	{
 		ctx.randcnt--;
@@ -33,8 +33,14 @@ namespace core
 		
 		uint32 getLowerBound() const { return a; }
 		uint32 getUpperBound() const { return b; }
+
+		// Pelny stan (typ generatora, przedzial i stan wewnetrzny) - po setState
+		// generator zwraca dokladnie te same liczby co po getState
+		void getState(std::vector<uint32>& state) const;
+		bool setState(const std::vector<uint32>& state);
 	private:
 		Random_pimpl* mpGenerator;
+		EGeneratorType type;
 		uint32 a, b;
 	};
 }
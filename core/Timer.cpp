@@ -27,6 +27,7 @@ namespace core
 
 		SetThreadAffinityMask(GetCurrentThread(), 1);
 		QueryPerformanceFrequency(&mFrequency);
+		QueryPerformanceCounter(&mStart);
 #else
 		gettimeofday(&mStart, NULL);
 #endif
@@ -53,8 +54,9 @@ namespace core
 #ifdef WIN32
 		LARGE_INTEGER time;
 		QueryPerformanceCounter(&time);
+		// wzgledem reset() - float nie pomiesci czasu od startu systemu z dokladnoscia do ms
 		return static_cast<float>(
-			static_cast<double>(time.QuadPart) / static_cast<double>(mFrequency.QuadPart));
+			static_cast<double>(time.QuadPart - mStart.QuadPart) / static_cast<double>(mFrequency.QuadPart));
 #else
 		timeval curr;
 		gettimeofday(&curr, NULL);
@@ -38,6 +38,7 @@ namespace core
 		float mTime;
 #ifdef WIN32
 		LARGE_INTEGER mFrequency;
+		LARGE_INTEGER mStart;
 #else
 		timeval mStart;
 #endif
@@ -12,14 +12,53 @@ QT       += core gui
 #CONFIG   += console
 CONFIG += debug_and_release
 DEFINES += EVO_QT_SUPPORT
+# Liczniki cykli dla faz algorytmu (Problem::showProfile)
+#DEFINES += EVO_PROFILE
+# Zapis przebiegu watkow do trace.json (Chrome trace-event)
+#DEFINES += EVO_TRACE
+# Sprzetowe liczniki wydajnosci (tylko Linux, perf_event_open)
+#DEFINES += EVO_PERF_COUNTERS
+# Obraz stanu co 100 pokolen do checkpoint.evo i wznowienie z niego przy starcie
+#DEFINES += EVO_CHECKPOINT
+# Adaptacyjny dobor operatorow, przebieg w operator_rates.txt
+#DEFINES += EVO_ADAPTIVE_OPERATORS
+# Pelny dziennik pokolen w generations.csv (w oknie tylko ostatnie 64k)
+#DEFINES += EVO_GENERATION_LOG_FILE
+# Lokalne przeszukiwanie sciezki krytycznej 10 najlepszych potomkow (50 ruchow)
+#DEFINES += EVO_LOCAL_SEARCH
+# Dekodowanie przerywane gdy potomek nie moze przejsc progu akceptacji
+#DEFINES += EVO_BOUNDED_DECODING
+# Wstepna ocena potomkow surogatem (wspolczynnik 1.05, audyt co 20.), precyzja i czulosc w logu
+#DEFINES += EVO_SCREENING
 
 SOURCES += main.cpp \
     Evo.cpp \
-	MainWindow.cpp
+	MainWindow.cpp \
+	Profiler.cpp \
+	Trace.cpp \
+	PerfCounters.cpp \
+	GenomePool.cpp \
+	Pareto.cpp \
+	Checkpoint.cpp \
+	ScheduleExport.cpp \
+	SeriesLod.cpp \
+	GenerationLog.cpp \
+	GanttIndex.cpp
 
 HEADERS += Evo.h \
 	MainWindow.h \
-	Plot.h
+	Plot.h \
+	Profiler.h \
+	Trace.h \
+	PerfCounters.h \
+	GenomePool.h \
+	Pareto.h \
+	Checkpoint.h \
+	ScheduleExport.h \
+	SeriesLod.h \
+	GenerationLog.h \
+	GanttIndex.h \
+	GanttView.h
 	
 FORMS += MainWindow.ui	
 
@@ -27,12 +66,19 @@ unix {
 	INCLUDEPATH += /usr/include/qwt
 	INCLUDEPATH += /usr/include/Qt
 	LIBS += -L./core/linux
+	# zapis obrazow stanu w tle (Checkpoint.cpp)
+	LIBS += -lpthread
 }
 win32 {
 	INCLUDEPATH += ./qwt/include/
 	LIBS += -L./core/win32 -L./qwt
 }
 	
+# libcore (core/linux, core/win32) musi byc przebudowana z biezacego core/:
+# core::Random ma pole 'type' i getState/setState (obrazy stanu), a biblioteka
+# sprzed tej zmiany ma inny uklad klasy - linkuje sie bez bledu, ale nie pasuje
+# do naglowka. Generator MT nie czyta juz state[-1], wiec co 624. liczba
+# rozni sie od starej sekwencji (stare przebiegi z ziarnem sie nie powtorza).
 build_pass:CONFIG(debug, debug|release) {
 	win32:LIBS += -lqwtd -lcore_d
 	unix: LIBS += -lqwt -lcore_d
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#include "Evo.h"
+
+// * Parametry pojedynczego rozwiazania dla narzedzi wsadowych (evod, evobatch).
+//   Klucze jak w wyniku evotune oraz population, seed, progress (co ile pokolen),
+//   warunki zatrzymania: generations, timeLimit (s), evaluations, stagnation,
+//   target (Problem::StopConditions, 0 - wylaczony) i przyspieszenia silnika:
+//   localSearch <topK>:<iteracje> (0 - wylaczone), boundedDecoding 0|1,
+//   screening <wspolczynnik> (0 - wylaczona) i screeningAudit <co ktory odrzucony>.
+struct SolveParams
+{
+	Problem::EPopulationModel popModel;
+	Problem::ESelectionScheme selection;
+	Problem::EFitnessModel fitness;
+	Problem::EDecoder decoder;
+	float selectivePressure;
+	float probCX;
+	float probMUT;
+	float probOperator;
+	float tempPopFraction;
+	float replaceCoeff;
+	core::uint32 tourGroupSize;
+	bool allowDuplicates;
+	bool genitor;
+	bool sequence;
+	core::uint32 popSize;
+	Problem::StopConditions stop;
+	core::uint32 seed;
+	bool hasSeed;
+	core::uint32 progressEvery;
+	core::uint32 lsTopK;
+	core::uint32 lsIterations;
+	bool boundedDecoding;
+	float screenFactor;
+	core::uint32 screenAudit;
+
+	SolveParams()
+	: popModel(Problem::PM_SIMPLE), selection(Problem::SS_TOURNAMENT),
+	fitness(Problem::FM_LINEARRANKING), decoder(Problem::DC_SEMIACTIVE),
+	selectivePressure(2.0f), probCX(0.5f), probMUT(0.1f), probOperator(0.5f),
+	tempPopFraction(0.1f), replaceCoeff(0.2f), tourGroupSize(4), allowDuplicates(true),
+	genitor(true), sequence(false), popSize(500), seed(0), hasSeed(false), progressEvery(0),
+	lsTopK(0), lsIterations(0), boundedDecoding(false), screenFactor(0.0f), screenAudit(0)
+	{
+		stop.maxGenerations = 500;
+	}
+
+	// false dla nieznanego klucza lub wartosci
+	bool set(const char* key, const char* value)
+	{
+		int index;
+		if(!strcmp(key, "populationModel"))
+		{
+			static const char* names[] = { "SIMPLE", "SS_UNIFORM", "SS_ELITISM", "SS_EXCESS" };
+			if(!findName(names, 4, value, index))
+				return false;
+			popModel = static_cast<Problem::EPopulationModel>(index);
+		}
+		else if(!strcmp(key, "selection"))
+		{
+			static const char* names[] = { "UNIFORM", "ROULETTE", "TOURNAMENT", "SUS", "RANKING" };
+			if(!findName(names, 5, value, index))
+				return false;
+			selection = static_cast<Problem::ESelectionScheme>(index);
+		}
+		else if(!strcmp(key, "fitness"))
+		{
+			static const char* names[] = { "LINEARRANKING", "SIGMASCALING", "RAWVALUE", "NSGA2" };
+			if(!findName(names, 4, value, index))
+				return false;
+			fitness = static_cast<Problem::EFitnessModel>(index);
+		}
+		else if(!strcmp(key, "decoder"))
+		{
+			static const char* names[] = { "SEMIACTIVE", "ACTIVE", "GT_ACTIVE", "GT_NONDELAY" };
+			if(!findName(names, 4, value, index))
+				return false;
+			decoder = static_cast<Problem::EDecoder>(index);
+		}
+		else if(!strcmp(key, "selectivePressure"))
+			selectivePressure = static_cast<float>(atof(value));
+		else if(!strcmp(key, "crossoverRate"))
+			probCX = static_cast<float>(atof(value));
+		else if(!strcmp(key, "mutationRate"))
+			probMUT = static_cast<float>(atof(value));
+		else if(!strcmp(key, "rowColumnOperatorRate"))
+			probOperator = static_cast<float>(atof(value));
+		else if(!strcmp(key, "temporaryPopulationFraction"))
+			tempPopFraction = static_cast<float>(atof(value));
+		else if(!strcmp(key, "reinsertionCoefficient"))
+			replaceCoeff = static_cast<float>(atof(value));
+		else if(!strcmp(key, "tournamentGroupSize"))
+			tourGroupSize = std::max(atoi(value), 1);
+		else if(!strcmp(key, "allowDuplicates"))
+			allowDuplicates = atoi(value) != 0;
+		else if(!strcmp(key, "genitor"))
+			genitor = atoi(value) != 0;
+		else if(!strcmp(key, "sequenceChromosome"))
+			sequence = atoi(value) != 0;
+		else if(!strcmp(key, "population"))
+			popSize = std::max(atoi(value), 2);
+		else if(!strcmp(key, "generations"))
+			stop.maxGenerations = std::max(atoi(value), 0);
+		else if(!strcmp(key, "timeLimit"))
+			stop.timeLimit = atof(value);
+		else if(!strcmp(key, "evaluations"))
+			stop.maxEvaluations = static_cast<core::uint64>(std::max(atof(value), 0.0));
+		else if(!strcmp(key, "stagnation"))
+			stop.stagnation = std::max(atoi(value), 0);
+		else if(!strcmp(key, "target"))
+			stop.target = std::max(atoi(value), 0);
+		else if(!strcmp(key, "seed"))
+		{
+			seed = static_cast<core::uint32>(strtoul(value, 0, 10));
+			hasSeed = true;
+		}
+		else if(!strcmp(key, "progress"))
+			progressEvery = std::max(atoi(value), 0);
+		else if(!strcmp(key, "localSearch"))
+		{
+			unsigned topK, iterations = 0;
+			int n = sscanf(value, "%u:%u", &topK, &iterations);
+			if(n < 1 || (n == 1 && topK != 0))
+				return false;
+			lsTopK = topK;
+			lsIterations = iterations;
+		}
+		else if(!strcmp(key, "boundedDecoding"))
+			boundedDecoding = atoi(value) != 0;
+		else if(!strcmp(key, "screening"))
+			screenFactor = static_cast<float>(atof(value));
+		else if(!strcmp(key, "screeningAudit"))
+			screenAudit = std::max(atoi(value), 0);
+		else
+			return false;
+		return true;
+	}
+
+	// Linia "klucz wartosc"; puste linie i komentarze (#) sa pomijane
+	bool setLine(const char* line)
+	{
+		char key[64], value[256];
+		int n = sscanf(line, "%63s %255s", key, value);
+		if(n <= 0 || key[0] == '#')
+			return true;
+		return n == 2 && set(key, value);
+	}
+
+	// Plik z liniami "klucz wartosc" (np. wynik evotune)
+	bool load(const char* filename)
+	{
+		FILE* fp = fopen(filename, "r");
+		if(!fp)
+		{
+			fprintf(stderr, "Error: couldn't open \"%s\"\n", filename);
+			return false;
+		}
+
+		char line[1024];
+		bool ok = true;
+		while(ok && fgets(line, sizeof(line), fp))
+		{
+			ok = setLine(line);
+			if(!ok)
+				fprintf(stderr, "Error: bad parameter in \"%s\": %s", filename, line);
+		}
+		fclose(fp);
+		return ok;
+	}
+
+	// Ustawia parametry i tworzy populacje poczatkowa (dane instancji juz wczytane)
+	void apply(Problem& p) const
+	{
+		if(hasSeed)
+			p.setSeed(seed);
+
+		p.setPopulationModel(popModel);
+		p.setSelectMethod(selection);
+		p.setFitnessModel(fitness, selectivePressure);
+		p.setProbability(probCX, probMUT);
+		p.setOperatorProbability(probOperator);
+		p.setGenitor(genitor);
+		p.setDecoder(decoder);
+		p.setSequenceChromosome(sequence);
+		p.setLocalSearch(lsTopK, lsIterations);
+		p.setBoundedDecoding(boundedDecoding);
+		p.setScreening(screenFactor, screenAudit);
+
+		core::uint32 extra = std::max(1U, static_cast<core::uint32>(tempPopFraction * popSize));
+		core::uint32 tempPopSize = popModel == Problem::PM_SS_EXCESS ? popSize + extra : extra;
+		p.setSSParameters(tempPopSize, replaceCoeff, popSize);
+		p.generateRandomSolutions(popSize);
+		p.setTournamentParameters(tourGroupSize, allowDuplicates);
+		p.setStopConditions(stop);
+	}
+
+private:
+	static bool findName(const char* const* names, int count, const char* value, int& index)
+	{
+		for(int i = 0; i < count; ++i)
+		{
+			if(!strcmp(names[i], value))
+			{
+				index = i;
+				return true;
+			}
+		}
+		return false;
+	}
+};
@@ -0,0 +1,285 @@
+// * Rozwiazywanie wielu niezaleznych instancji naraz.
+//
+//   Male instancje ida rownolegle, po jednej na watek (kazda jednowatkowo -
+//   przy malej populacji zrownoleglenie wewnatrz pokolenia prawie nic nie daje).
+//   Instancje od 'large' operacji sa odkladane i liczone po kolei, kazda
+//   wszystkimi watkami (OpenMP wewnatrz Problem).
+//
+//   evobatch [opcje] instancja.dat ...
+//     -params plik    parametry "klucz wartosc" (jak w wyniku evotune)
+//     -set k=w        pojedynczy parametr, nadpisuje wartosc z pliku
+//     -list plik      dodatkowe instancje, jedna sciezka w linii
+//     -workers N      jednoczesnych rozwiazan (liczba rdzeni)
+//     -large N        od ilu operacji instancja liczona jest wszystkimi watkami (5000)
+//     -summary plik   podsumowanie CSV (batch_summary.csv)
+//
+//   Podsumowanie: wiersz na instancje (w kolejnosci wejscia)
+//     instance,jobs,machines,operations,lowerBound,makespan,gap,generations,seconds,threads,stop
+//   (makespan pusty gdy instancji nie udalo sie wczytac; seconds - samo rozwiazanie,
+//   bez wczytania instancji), na koncu linie '#'
+//   z czasem calkowitym i przepustowoscia w rozwiazaniach na godzine
+//   oraz (przy parametrze screening) skutecznoscia wstepnej oceny potomkow.
+
+#include <omp.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "SolveParams.h"
+
+using namespace core;
+
+namespace
+{
+	struct Settings
+	{
+		SolveParams params;
+		std::vector<std::string> instances;
+		int numWorkers;
+		uint32 largeOps;
+		const char* summary;
+	};
+
+	struct Result
+	{
+		bool ok;
+		uint32 numJobs;
+		uint32 numMachines;
+		uint32 numOps;
+		uint32 lowerBound;
+		uint32 makespan;
+		uint32 generations;
+		double seconds;
+		int threads;
+		Problem::EStopReason stop;
+		Problem::ScreeningStats screening;
+		bool large;
+		// duza instancja czekajaca na faze 2
+		Problem* deferred;
+
+		Result() : ok(false), numJobs(0), numMachines(0), numOps(0), lowerBound(0),
+			makespan(0), generations(0), seconds(0.0), threads(0),
+			stop(Problem::SR_NONE), screening(), large(false), deferred(0) {}
+	};
+
+	// Rozwiazanie wczytanej instancji - czas od populacji poczatkowej, bez wczytania
+	// (duze instancje sa wczytywane w fazie 1, a liczone w fazie 2)
+	void solve(Problem& p, const SolveParams& params, Result& r)
+	{
+		double begin = omp_get_wtime();
+		params.apply(p);
+		r.stop = p.run();
+
+		r.ok = true;
+		r.makespan = p.minObjective;
+		r.generations = p.getGeneration();
+		r.seconds = omp_get_wtime() - begin;
+		r.screening = p.getScreeningStats();
+	}
+
+	bool readList(const char* filename, std::vector<std::string>& instances)
+	{
+		FILE* fp = fopen(filename, "r");
+		if(!fp)
+		{
+			fprintf(stderr, "Error: couldn't open \"%s\"\n", filename);
+			return false;
+		}
+
+		char line[4096];
+		while(fgets(line, sizeof(line), fp))
+		{
+			size_t n = strlen(line);
+			while(n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r' || line[n - 1] == ' '))
+				line[--n] = 0;
+			if(n > 0 && line[0] != '#')
+				instances.push_back(line);
+		}
+		fclose(fp);
+		return true;
+	}
+
+	void usage()
+	{
+		fprintf(stderr, "usage: evobatch [-params file] [-set key=value]... [-list file]\n"
+			"                [-workers N] [-large OPS] [-summary file.csv] instance.dat ...\n");
+	}
+
+	bool parseArgs(int argc, char** argv, Settings& s)
+	{
+		s.numWorkers = omp_get_num_procs();
+		s.largeOps = 5000;
+		s.summary = "batch_summary.csv";
+
+		for(int i = 1; i < argc; ++i)
+		{
+			const char* arg = argv[i];
+			if(arg[0] != '-')
+			{
+				s.instances.push_back(arg);
+				continue;
+			}
+			if(i + 1 >= argc)
+			{
+				fprintf(stderr, "Error: missing value for %s\n", arg);
+				return false;
+			}
+
+			const char* value = argv[++i];
+			bool ok = true;
+			if(!strcmp(arg, "-params"))
+				ok = s.params.load(value);
+			else if(!strcmp(arg, "-set"))
+			{
+				std::string param(value);
+				size_t eq = param.find('=');
+				ok = eq != std::string::npos &&
+					s.params.set(param.substr(0, eq).c_str(), param.c_str() + eq + 1);
+			}
+			else if(!strcmp(arg, "-list"))
+				ok = readList(value, s.instances);
+			else if(!strcmp(arg, "-workers"))
+				ok = (s.numWorkers = atoi(value)) > 0;
+			else if(!strcmp(arg, "-large"))
+				s.largeOps = static_cast<uint32>(strtoul(value, 0, 10));
+			else if(!strcmp(arg, "-summary"))
+				s.summary = value;
+			else
+			{
+				fprintf(stderr, "Error: unknown option %s\n", arg);
+				return false;
+			}
+
+			if(!ok)
+			{
+				fprintf(stderr, "Error: bad value for %s: %s\n", arg, value);
+				return false;
+			}
+		}
+		return !s.instances.empty();
+	}
+}
+
+// -------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	Settings s;
+	if(!parseArgs(argc, argv, s))
+	{
+		usage();
+		return 1;
+	}
+
+	int32 numInstances = static_cast<int32>(s.instances.size());
+	std::vector<Result> results(numInstances);
+	double begin = omp_get_wtime();
+
+	// * Step 1: male instancje - jedna na watek, bez zagniezdzonej rownoleglosci.
+	//   Problem przydziela bufory na omp_get_max_threads() watkow przy wczytaniu,
+	//   a poza wlasnymi regionami indeksuje je numerem watku zewnetrznego - liczba
+	//   watkow ustawiona przed regionem obejmuje oba przypadki (przy -workers 1
+	//   region jest nieaktywny i wewnetrzne dostaja jeden watek)
+	omp_set_nested(0);
+	omp_set_num_threads(s.numWorkers);
+	#pragma omp parallel for schedule(dynamic, 1)
+	for(int32 i = 0; i < numInstances; ++i)
+	{
+		Result& r = results[i];
+		Problem* p = new Problem();
+		if(!p->loadInitialData(s.instances[i].c_str()))
+		{
+			delete p;
+			continue;
+		}
+
+		r.numJobs = p->getNumJobs();
+		r.numMachines = p->getNumMachines();
+		r.numOps = p->getNumOps();
+		r.lowerBound = p->getLowerBound();
+
+		if(r.numOps >= s.largeOps)
+		{
+			r.large = true;
+			r.deferred = p;
+			continue;
+		}
+
+		r.threads = 1;
+		solve(*p, s.params, r);
+		delete p;
+	}
+
+	// * Step 2: duze instancje po kolei, wszystkimi watkami
+	for(int32 i = 0; i < numInstances; ++i)
+	{
+		Result& r = results[i];
+		if(!r.deferred)
+			continue;
+
+		r.threads = s.numWorkers;
+		solve(*r.deferred, s.params, r);
+		delete r.deferred;
+		r.deferred = 0;
+	}
+
+	double seconds = omp_get_wtime() - begin;
+
+	// * Step 3: podsumowanie
+	FILE* fp = fopen(s.summary, "w");
+	if(!fp)
+	{
+		fprintf(stderr, "Can't open %s for writing\n", s.summary);
+		return 1;
+	}
+
+	fprintf(fp, "instance,jobs,machines,operations,lowerBound,makespan,gap,generations,seconds,threads,stop\n");
+	uint32 solved = 0;
+	uint32 large = 0;
+	double solveSeconds = 0.0;
+	Problem::ScreeningStats screening = Problem::ScreeningStats();
+	for(int32 i = 0; i < numInstances; ++i)
+	{
+		const Result& r = results[i];
+		if(!r.ok)
+		{
+			fprintf(fp, "%s,,,,,,,,,,\n", s.instances[i].c_str());
+			continue;
+		}
+
+		double gap = r.lowerBound ? static_cast<double>(r.makespan) / r.lowerBound - 1.0 : 0.0;
+		fprintf(fp, "%s,%u,%u,%u,%u,%u,%.4f,%u,%.3f,%d,%s\n", s.instances[i].c_str(),
+			r.numJobs, r.numMachines, r.numOps, r.lowerBound, r.makespan, gap,
+			r.generations, r.seconds, r.threads, Problem::stopReasonName(r.stop));
+
+		++solved;
+		if(r.large)
+			++large;
+		solveSeconds += r.seconds;
+		screening.passed += r.screening.passed;
+		screening.passedGood += r.screening.passedGood;
+		screening.screenedOut += r.screening.screenedOut;
+		screening.audited += r.screening.audited;
+		screening.auditedGood += r.screening.auditedGood;
+	}
+
+	double throughput = seconds > 0.0 ? solved * 3600.0 / seconds : 0.0;
+	fprintf(fp, "# instances %d, solved %u (%u with %d threads), failed %u\n",
+		numInstances, solved, large, s.numWorkers, numInstances - solved);
+	fprintf(fp, "# wall %.3f s, sum of solve times %.3f s, throughput %.1f solves/hour\n",
+		seconds, solveSeconds, throughput);
+	if(screening.passed + screening.screenedOut > 0)
+	{
+		fprintf(fp, "# screening: passed %llu, screened out %llu (audited %llu), skipped decodes %llu, "
+			"precision %.2f%%, recall %.2f%%\n", static_cast<unsigned long long>(screening.passed),
+			static_cast<unsigned long long>(screening.screenedOut),
+			static_cast<unsigned long long>(screening.audited),
+			static_cast<unsigned long long>(screening.skipped()),
+			100.0 * screening.precision(), 100.0 * screening.recall());
+	}
+	bool ok = fclose(fp) == 0;
+
+	fprintf(stderr, "%u/%d instances solved in %.3f s (%.1f solves/hour), summary in %s\n",
+		solved, numInstances, seconds, throughput, s.summary);
+	return ok && solved == static_cast<uint32>(numInstances) ? 0 : 1;
+}
+// -------------------------------------------------------------------------
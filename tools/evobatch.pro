@@ -0,0 +1,46 @@
+#-------------------------------------------------
+#
+# Rozwiazywanie wielu instancji naraz (bez GUI)
+#
+#-------------------------------------------------
+
+TARGET = evobatch
+TEMPLATE = app
+
+QT       -= core gui
+CONFIG   += console
+CONFIG   -= app_bundle
+
+INCLUDEPATH += ..
+
+SOURCES += evobatch.cpp \
+	../Evo.cpp \
+	../Profiler.cpp \
+	../Trace.cpp \
+	../PerfCounters.cpp \
+	../GenomePool.cpp \
+	../Pareto.cpp \
+	../Checkpoint.cpp \
+	../ScheduleExport.cpp
+
+HEADERS += ../Evo.h \
+	SolveParams.h
+
+unix {
+	LIBS += -L../core/linux -lpthread
+}
+win32 {
+	LIBS += -L../core/win32
+}
+
+# libcore przebudowana z biezacego core/ (patrz evo.pro)
+build_pass:CONFIG(debug, debug|release) {
+	LIBS += -lcore_d
+}
+build_pass:CONFIG(release, debug|release) {
+	LIBS += -lcore
+}
+
+# OpenMP
+QMAKE_CXXFLAGS += -fopenmp
+QMAKE_LFLAGS += -fopenmp
@@ -0,0 +1,211 @@
+// * Klient serwera evod - wysyla instancje z parametrami, postep i wynik
+//   wypisuje na stderr, harmonogram najlepszego rozwiazania (CSV) do pliku
+//   lub na stdout.
+//
+//   evoc [-socket sciezka] [-params plik] [-set klucz=wartosc]... [-o plik.csv]
+//        [-quiet] instancja.dat
+//     -params   plik z liniami "klucz wartosc" (np. wynik evotune)
+//     -set      pojedynczy parametr, nadpisuje wartosc z pliku
+//     -quiet    bez linii PROGRESS
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace
+{
+	struct Settings
+	{
+		const char* socketPath;
+		const char* paramsFile;
+		const char* outputFile;
+		const char* instanceFile;
+		std::vector<std::string> params;
+		bool quiet;
+	};
+
+	bool readFile(const char* filename, std::string& data)
+	{
+		FILE* fp = fopen(filename, "rb");
+		if(!fp)
+		{
+			fprintf(stderr, "Error: couldn't open \"%s\"\n", filename);
+			return false;
+		}
+
+		char chunk[1 << 16];
+		size_t n;
+		while((n = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+			data.append(chunk, n);
+		bool ok = !ferror(fp);
+		fclose(fp);
+		return ok;
+	}
+
+	bool sendAll(int fd, const char* data, size_t size)
+	{
+		while(size > 0)
+		{
+			ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+			if(n <= 0)
+				return false;
+			data += n;
+			size -= n;
+		}
+		return true;
+	}
+
+	bool parseArgs(int argc, char** argv, Settings& s)
+	{
+		s.socketPath = "/tmp/evod.sock";
+		s.paramsFile = 0;
+		s.outputFile = 0;
+		s.instanceFile = 0;
+		s.quiet = false;
+
+		for(int i = 1; i < argc; ++i)
+		{
+			const char* arg = argv[i];
+			if(arg[0] != '-')
+			{
+				s.instanceFile = arg;
+				continue;
+			}
+			if(!strcmp(arg, "-quiet"))
+			{
+				s.quiet = true;
+				continue;
+			}
+			if(i + 1 >= argc)
+				return false;
+
+			const char* value = argv[++i];
+			if(!strcmp(arg, "-socket"))
+				s.socketPath = value;
+			else if(!strcmp(arg, "-params"))
+				s.paramsFile = value;
+			else if(!strcmp(arg, "-o"))
+				s.outputFile = value;
+			else if(!strcmp(arg, "-set"))
+			{
+				std::string param(value);
+				size_t eq = param.find('=');
+				if(eq == std::string::npos)
+					return false;
+				param[eq] = ' ';
+				s.params.push_back(param);
+			}
+			else
+				return false;
+		}
+		return s.instanceFile != 0 &&
+			strlen(s.socketPath) < sizeof(reinterpret_cast<sockaddr_un*>(0)->sun_path);
+	}
+}
+
+// -------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	Settings s;
+	if(!parseArgs(argc, argv, s))
+	{
+		fprintf(stderr, "usage: evoc [-socket path] [-params file] [-set key=value]...\n"
+			"            [-o schedule.csv] [-quiet] instance.dat\n");
+		return 1;
+	}
+
+	// * Step 1: zlecenie - parametry z pliku, potem z -set (serwer bierze ostatnia wartosc)
+	std::string request("SOLVE\n");
+	if(s.paramsFile)
+	{
+		std::string params;
+		if(!readFile(s.paramsFile, params))
+			return 1;
+		request += params;
+		if(!params.empty() && params[params.size() - 1] != '\n')
+			request += '\n';
+	}
+	for(size_t i = 0; i < s.params.size(); ++i)
+		request += s.params[i] + '\n';
+
+	std::string instance;
+	if(!readFile(s.instanceFile, instance))
+		return 1;
+
+	char line[1024];
+	sprintf(line, "instance %lu\n", static_cast<unsigned long>(instance.size()));
+	request += line;
+	request += instance;
+
+	// * Step 2: wyslanie
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, s.socketPath);
+
+	if(fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+	{
+		perror(s.socketPath);
+		return 1;
+	}
+	if(!sendAll(fd, request.data(), request.size()))
+	{
+		fprintf(stderr, "Error: couldn't send request\n");
+		close(fd);
+		return 1;
+	}
+	shutdown(fd, SHUT_WR);
+
+	// * Step 3: odpowiedz
+	FILE* in = fdopen(fd, "r");
+	FILE* out = 0;
+	bool inSchedule = false;
+	bool done = false;
+	int status = 1;
+
+	while(!done && fgets(line, sizeof(line), in))
+	{
+		if(inSchedule)
+		{
+			if(!strcmp(line, "END\n"))
+			{
+				done = true;
+				status = 0;
+			}
+			else
+				fputs(line, out);
+		}
+		else if(!strncmp(line, "SCHEDULE ", 9))
+		{
+			out = s.outputFile ? fopen(s.outputFile, "w") : stdout;
+			if(!out)
+			{
+				fprintf(stderr, "Error: couldn't open \"%s\" for writing\n", s.outputFile);
+				break;
+			}
+			inSchedule = true;
+		}
+		else if(!strncmp(line, "ERROR ", 6))
+		{
+			fprintf(stderr, "evod: %s", line + 6);
+			break;
+		}
+		else if(!s.quiet || strncmp(line, "PROGRESS ", 9) != 0)
+			fputs(line, stderr);
+	}
+
+	if(!done && status != 0 && inSchedule)
+		fprintf(stderr, "Error: connection closed before the end of the schedule\n");
+	if(out && out != stdout && fclose(out) != 0)
+		status = 1;
+	fclose(in);
+	return status;
+}
+// -------------------------------------------------------------------------
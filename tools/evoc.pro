@@ -0,0 +1,14 @@
+#-------------------------------------------------
+#
+# Klient serwera obliczen evod (tylko Linux)
+#
+#-------------------------------------------------
+
+TARGET = evoc
+TEMPLATE = app
+
+QT       -= core gui
+CONFIG   += console
+CONFIG   -= app_bundle
+
+SOURCES += evoc.cpp
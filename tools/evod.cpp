@@ -0,0 +1,496 @@
+// * Serwer obliczen (gniazdo Unix) - proces startuje raz, instancje sa
+//   trzymane w pamieci, a watki robocze (kazdy z wlasna, rozgrzana pula OpenMP)
+//   obsluguja kilka zadan jednoczesnie.
+//
+//   evod [-socket sciezka] [-workers N] [-threads N] [-cache N]
+//     -socket   sciezka gniazda (/tmp/evod.sock)
+//     -workers  liczba jednoczesnych obliczen (2)
+//     -threads  watki OpenMP na jedno obliczenie (rdzenie / workers)
+//     -cache    najwiecej instancji w pamieci (16)
+//
+//   Protokol (tekstowy, linie zakonczone '\n'):
+//     klient:  SOLVE
+//              <klucz> <wartosc>       parametry (jak w wyniku evotune) oraz
+//                                      population, seed, progress (co ile pokolen),
+//                                      generations, timeLimit (s), evaluations,
+//                                      stagnation, target, localSearch,
+//                                      boundedDecoding, screening, screeningAudit
+//              instance <N>            po tej linii N bajtow pliku instancji
+//     serwer:  INSTANCE <skrot> parsed|cached <zadania> <maszyny> <operacje>
+//              PROGRESS <pokolenie> <min> <srednia> <max>      (opcjonalnie)
+//              RESULT <makespan> <ograniczenie> <pokolenia> <sekundy> <powod zatrzymania>
+//              SCHEDULE csv
+//              <harmonogram najlepszego rozwiazania w CSV>
+//              END
+//     lub      ERROR <opis>
+//   Zerwanie polaczenia przerywa obliczenia (sprawdzane co pokolenie).
+
+#include <omp.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+#include <csignal>
+#include <cerrno>
+#include <deque>
+#include <map>
+#include <sstream>
+
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <sys/un.h>
+
+#include "SolveParams.h"
+
+using namespace core;
+
+namespace
+{
+	struct Settings
+	{
+		const char* socketPath;
+		uint32 numWorkers;
+		uint32 threadsPerSolve;
+		uint32 cacheSize;
+	};
+
+	// najwiekszy przyjmowany plik instancji
+	const unsigned long MAX_INSTANCE_SIZE = 1UL << 30;
+
+	volatile sig_atomic_t quit = 0;
+
+	void onSignal(int)
+	{
+		quit = 1;
+	}
+
+	// * Sparsowane instancje wg skrotu zawartosci. Po przekroczeniu rozmiaru
+	//   usuwana jest najdawniej uzywana
+	class InstanceCache
+	{
+	public:
+		InstanceCache(uint32 capacity) : capacity(capacity), clock(0)
+		{
+			pthread_mutex_init(&mutex, 0);
+		}
+
+		~InstanceCache()
+		{
+			for(std::map<uint64, Entry>::iterator it = entries.begin(); it != entries.end(); ++it)
+				delete it->second.shared;
+			pthread_mutex_destroy(&mutex);
+		}
+
+		// Kopiuje dane instancji do 'target'; 'cached' - czy instancja byla juz w pamieci
+		bool acquire(const std::string& data, uint64 hash, Problem& target, bool& cached)
+		{
+			pthread_mutex_lock(&mutex);
+			std::map<uint64, Entry>::iterator it = entries.find(hash);
+			cached = it != entries.end();
+			if(cached)
+			{
+				// kopia poza sekcja krytyczna - licznik chroni instancje przed usunieciem
+				Shared* shared = it->second.shared;
+				it->second.lastUse = ++clock;
+				shared->users++;
+				pthread_mutex_unlock(&mutex);
+
+				bool ok = target.copyInitialData(*shared->problem);
+
+				pthread_mutex_lock(&mutex);
+				release(shared);
+				pthread_mutex_unlock(&mutex);
+				return ok;
+			}
+			pthread_mutex_unlock(&mutex);
+
+			// parsowanie poza sekcja krytyczna
+			Problem* parsed = new Problem();
+			std::istringstream in(data);
+			if(!parsed->loadInitialData(in) || !target.copyInitialData(*parsed))
+			{
+				delete parsed;
+				return false;
+			}
+
+			pthread_mutex_lock(&mutex);
+			if(entries.find(hash) != entries.end())
+			{
+				// ten sam plik sparsowany rownolegle przez inny watek
+				delete parsed;
+			}
+			else
+			{
+				if(entries.size() >= capacity)
+					evictOldest();
+				Entry e = { new Shared(parsed), ++clock };
+				entries[hash] = e;
+			}
+			pthread_mutex_unlock(&mutex);
+			return true;
+		}
+
+	private:
+		// Instancja z liczba uzytkownikow (sama pamiec podrecznej jest jednym z nich)
+		struct Shared
+		{
+			Problem* problem;
+			uint32 users;
+
+			explicit Shared(Problem* problem) : problem(problem), users(1) {}
+			~Shared() { delete problem; }
+
+		private:
+			Shared(const Shared&);
+			Shared& operator=(const Shared&);
+		};
+
+		struct Entry
+		{
+			Shared* shared;
+			uint64 lastUse;
+		};
+
+		std::map<uint64, Entry> entries;
+		uint32 capacity;
+		uint64 clock;
+		pthread_mutex_t mutex;
+
+		void evictOldest()
+		{
+			std::map<uint64, Entry>::iterator oldest = entries.begin();
+			for(std::map<uint64, Entry>::iterator it = entries.begin(); it != entries.end(); ++it)
+			{
+				if(it->second.lastUse < oldest->second.lastUse)
+					oldest = it;
+			}
+			release(oldest->second.shared);
+			entries.erase(oldest);
+		}
+
+		// Pod blokada; ostatni uzytkownik usuwa instancje
+		void release(Shared* shared)
+		{
+			if(--shared->users == 0)
+				delete shared;
+		}
+	};
+
+	// * Kolejka polaczen do obsluzenia (-1 konczy watek roboczy)
+	class ConnectionQueue
+	{
+	public:
+		ConnectionQueue()
+		{
+			pthread_mutex_init(&mutex, 0);
+			pthread_cond_init(&cond, 0);
+		}
+
+		~ConnectionQueue()
+		{
+			pthread_cond_destroy(&cond);
+			pthread_mutex_destroy(&mutex);
+		}
+
+		void push(int fd)
+		{
+			pthread_mutex_lock(&mutex);
+			fds.push_back(fd);
+			pthread_cond_signal(&cond);
+			pthread_mutex_unlock(&mutex);
+		}
+
+		int pop()
+		{
+			pthread_mutex_lock(&mutex);
+			while(fds.empty())
+				pthread_cond_wait(&cond, &mutex);
+			int fd = fds.front();
+			fds.pop_front();
+			pthread_mutex_unlock(&mutex);
+			return fd;
+		}
+
+	private:
+		std::deque<int> fds;
+		pthread_mutex_t mutex;
+		pthread_cond_t cond;
+	};
+
+	// Odczyt linii bez '\n'
+	bool readLine(FILE* in, char* line, int size)
+	{
+		if(!fgets(line, size, in))
+			return false;
+		size_t n = strlen(line);
+		while(n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r'))
+			line[--n] = 0;
+		return true;
+	}
+
+	// Czy klient zamknal polaczenie (bez czekania). Sam koniec strumienia nie
+	// wystarcza - klient moze zamknac tylko swoja strone zapisu (evoc) i czekac
+	// na wynik; gniazdo Unix zglasza POLLHUP dopiero po zamknieciu obu stron
+	bool clientGone(int fd)
+	{
+		pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = 0;
+		pfd.revents = 0;
+		return poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLHUP | POLLERR | POLLNVAL)) != 0;
+	}
+
+	// Odpowiedz; false gdy klient sie rozlaczyl
+	bool reply(FILE* out, const char* format, ...)
+	{
+		va_list args;
+		va_start(args, format);
+		vfprintf(out, format, args);
+		va_end(args);
+		return fflush(out) == 0 && !ferror(out);
+	}
+
+	void solve(FILE* in, FILE* out, InstanceCache& cache)
+	{
+		char line[1024];
+		if(!readLine(in, line, sizeof(line)) || strcmp(line, "SOLVE") != 0)
+		{
+			reply(out, "ERROR expected SOLVE\n");
+			return;
+		}
+
+		// * Step 1: parametry i dane instancji
+		SolveParams r;
+		unsigned long instanceSize = 0;
+		for(;;)
+		{
+			if(!readLine(in, line, sizeof(line)))
+				return;
+
+			if(sscanf(line, "instance %lu", &instanceSize) == 1)
+				break;
+			if(!r.setLine(line))
+			{
+				reply(out, "ERROR bad parameter: %s\n", line);
+				return;
+			}
+		}
+
+		if(instanceSize == 0 || instanceSize > MAX_INSTANCE_SIZE)
+		{
+			reply(out, "ERROR bad instance size\n");
+			return;
+		}
+
+		std::string data(instanceSize, 0);
+		if(fread(&data[0], 1, instanceSize, in) != instanceSize)
+		{
+			reply(out, "ERROR incomplete instance\n");
+			return;
+		}
+
+		double begin = omp_get_wtime();
+		uint64 hash = fnv1a(&data[0], data.size());
+
+		Problem p;
+		bool cached;
+		if(!cache.acquire(data, hash, p, cached))
+		{
+			reply(out, "ERROR couldn't parse instance\n");
+			return;
+		}
+
+		if(!reply(out, "INSTANCE %016llx %s %u %u %u\n", static_cast<unsigned long long>(hash),
+			cached ? "cached" : "parsed", p.getNumJobs(), p.getNumMachines(), p.getNumOps()))
+			return;
+
+		// * Step 2: obliczenia (najlepszy dotad - rowniez gdy bez GENITOR'a sie pogorszy)
+		p.setAnytime(true);
+		r.apply(p);
+
+		// zerwanie polaczenia sprawdzane co pokolenie, niezaleznie od 'progress'
+		int fd = fileno(in);
+		while(!p.shouldStop())
+		{
+			p.nextGen();
+			if(clientGone(fd))
+				return;
+
+			uint32 gen = p.getGeneration();
+			if(r.progressEvery && gen % r.progressEvery == 0)
+			{
+				if(!reply(out, "PROGRESS %u %u %.3f %u\n", gen,
+					p.minObjective, p.average, p.maxObjective))
+					return;
+			}
+		}
+
+		// * Step 3: wynik i harmonogram najlepszego rozwiazania
+		ScheduleTable table;
+		p.getBestSchedule(table);
+
+		if(!reply(out, "RESULT %u %u %u %.3f %s\n", table.makespan, p.getLowerBound(),
+			p.getGeneration(), omp_get_wtime() - begin, Problem::stopReasonName(p.getStopReason())))
+			return;
+
+		fputs("SCHEDULE csv\n", out);
+		ScheduleWriter writer;
+		writer.open(out, ScheduleWriter::SF_CSV, 0, 0);
+		writer.write(table);
+		if(writer.close())
+			reply(out, "END\n");
+	}
+
+	struct Worker
+	{
+		pthread_t thread;
+		ConnectionQueue* queue;
+		InstanceCache* cache;
+		uint32 threads;
+	};
+
+	void* workerMain(void* arg)
+	{
+		Worker& w = *static_cast<Worker*>(arg);
+
+		// pula OpenMP tego watku powstaje przy pierwszym obliczeniu i zostaje
+		omp_set_num_threads(w.threads);
+
+		for(;;)
+		{
+			int fd = w.queue->pop();
+			if(fd < 0)
+				break;
+
+			FILE* in = fdopen(fd, "r");
+			int outFd = dup(fd);
+			FILE* out = outFd >= 0 ? fdopen(outFd, "w") : 0;
+			if(in && out)
+				solve(in, out, *w.cache);
+
+			if(out)
+				fclose(out);
+			else if(outFd >= 0)
+				close(outFd);
+			if(in)
+				fclose(in);
+			else
+				close(fd);
+		}
+		return 0;
+	}
+
+	bool parseArgs(int argc, char** argv, Settings& s)
+	{
+		s.socketPath = "/tmp/evod.sock";
+		s.numWorkers = 2;
+		s.threadsPerSolve = 0;
+		s.cacheSize = 16;
+
+		for(int i = 1; i + 1 < argc; i += 2)
+		{
+			const char* arg = argv[i];
+			const char* value = argv[i + 1];
+			if(!strcmp(arg, "-socket"))
+				s.socketPath = value;
+			else if(!strcmp(arg, "-workers"))
+				s.numWorkers = std::max(atoi(value), 1);
+			else if(!strcmp(arg, "-threads"))
+				s.threadsPerSolve = std::max(atoi(value), 1);
+			else if(!strcmp(arg, "-cache"))
+				s.cacheSize = std::max(atoi(value), 1);
+			else
+				return false;
+		}
+		if(argc % 2 == 0)
+			return false;
+
+		if(!s.threadsPerSolve)
+			s.threadsPerSolve = std::max(omp_get_num_procs() / static_cast<int>(s.numWorkers), 1);
+		return strlen(s.socketPath) < sizeof(reinterpret_cast<sockaddr_un*>(0)->sun_path);
+	}
+}
+
+// -------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	Settings s;
+	if(!parseArgs(argc, argv, s))
+	{
+		fprintf(stderr, "usage: evod [-socket path] [-workers N] [-threads N] [-cache N]\n");
+		return 1;
+	}
+
+	int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(listenFd < 0)
+	{
+		perror("socket");
+		return 1;
+	}
+
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, s.socketPath);
+	unlink(s.socketPath);
+
+	if(bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+		listen(listenFd, 64) < 0)
+	{
+		perror(s.socketPath);
+		close(listenFd);
+		return 1;
+	}
+
+	// zerwane polaczenie - blad zapisu zamiast konca procesu
+	signal(SIGPIPE, SIG_IGN);
+
+	// bez SA_RESTART - accept wraca z EINTR
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = onSignal;
+	sigaction(SIGINT, &sa, 0);
+	sigaction(SIGTERM, &sa, 0);
+
+	ConnectionQueue queue;
+	InstanceCache cache(s.cacheSize);
+	std::vector<Worker> workers(s.numWorkers);
+	for(uint32 i = 0; i < s.numWorkers; ++i)
+	{
+		workers[i].queue = &queue;
+		workers[i].cache = &cache;
+		workers[i].threads = s.threadsPerSolve;
+		if(pthread_create(&workers[i].thread, 0, workerMain, &workers[i]) != 0)
+		{
+			fprintf(stderr, "Error: couldn't start worker threads\n");
+			return 1;
+		}
+	}
+
+	fprintf(stderr, "evod: listening on %s, %u workers x %u threads\n",
+		s.socketPath, s.numWorkers, s.threadsPerSolve);
+
+	while(!quit)
+	{
+		int fd = accept(listenFd, 0, 0);
+		if(fd < 0)
+		{
+			if(errno != EINTR)
+				perror("accept");
+			continue;
+		}
+		queue.push(fd);
+	}
+
+	// biezace obliczenia sa konczone, oczekujace polaczenia obslugiwane
+	for(uint32 i = 0; i < s.numWorkers; ++i)
+		queue.push(-1);
+	for(uint32 i = 0; i < s.numWorkers; ++i)
+		pthread_join(workers[i].thread, 0);
+
+	close(listenFd);
+	unlink(s.socketPath);
+	return 0;
+}
+// -------------------------------------------------------------------------
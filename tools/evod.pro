@@ -0,0 +1,41 @@
+#-------------------------------------------------
+#
+# Serwer obliczen na gniezdzie Unix (tylko Linux)
+#
+#-------------------------------------------------
+
+TARGET = evod
+TEMPLATE = app
+
+QT       -= core gui
+CONFIG   += console
+CONFIG   -= app_bundle
+
+INCLUDEPATH += ..
+
+SOURCES += evod.cpp \
+	../Evo.cpp \
+	../Profiler.cpp \
+	../Trace.cpp \
+	../PerfCounters.cpp \
+	../GenomePool.cpp \
+	../Pareto.cpp \
+	../Checkpoint.cpp \
+	../ScheduleExport.cpp
+
+HEADERS += ../Evo.h \
+	SolveParams.h
+
+LIBS += -L../core/linux -lpthread
+
+# libcore przebudowana z biezacego core/ (patrz evo.pro)
+build_pass:CONFIG(debug, debug|release) {
+	LIBS += -lcore_d
+}
+build_pass:CONFIG(release, debug|release) {
+	LIBS += -lcore
+}
+
+# OpenMP
+QMAKE_CXXFLAGS += -fopenmp
+QMAKE_LFLAGS += -fopenmp
@@ -0,0 +1,516 @@
+// * Strojenie parametrow algorytmu metoda wyscigu (iterowany F-race).
+//
+//   Kazda iteracja losuje konfiguracje (pierwsza - rownomiernie z calej
+//   przestrzeni, kolejne - wokol elity poprzedniej iteracji) i sciga je na
+//   kolejnych blokach (instancja, ziarno). Po kazdym bloku, od 'first' blokow,
+//   test Friedmana na rangach w blokach; gdy roznice sa istotne, konfiguracje
+//   istotnie gorsze od najlepszej (porownanie parami rang) odpadaja. Wyscig
+//   konczy sie po 'blocks' blokach lub gdy zostanie 'elites' konfiguracji.
+//
+//   Wszystkie biegi jednego bloku ida rownolegle (OpenMP, jeden watek na bieg),
+//   instancje sa wczytywane raz (Problem::copyInitialData), wyniki elity sa
+//   zapamietywane miedzy iteracjami. Miara - odleglosc najlepszego rozwiazania
+//   od dolnego ograniczenia po zadanej liczbie dekodowan.
+//
+//   evotune [opcje] instancja.dat ...
+//     -configs N      konfiguracji w iteracji (24)
+//     -iterations N   iteracji (3)
+//     -elites N       konfiguracji przechodzacych do nastepnej iteracji (4)
+//     -blocks N       najwiecej blokow w wyscigu (20)
+//     -first N        blokow przed pierwszym testem (5)
+//     -alpha F        poziom istotnosci (0.05)
+//     -pop N          rozmiar populacji (200)
+//     -evaluations N  budzet dekodowan na bieg (40000)
+//     -seed N         ziarno (1)
+//     -o plik         zapis najlepszej konfiguracji
+
+#include <omp.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "Evo.h"
+
+using namespace core;
+
+namespace
+{
+	struct Settings
+	{
+		uint32 numConfigs;
+		uint32 numIterations;
+		uint32 numElites;
+		uint32 maxBlocks;
+		uint32 firstTest;
+		float alpha;
+		uint32 popSize;
+		uint32 evaluations;
+		uint32 seed;
+		const char* output;
+		std::vector<const char*> instances;
+	};
+
+	// Jedna konfiguracja (odpowiedniki pol formularza)
+	struct Config
+	{
+		uint32 id;
+		Problem::EPopulationModel popModel;
+		Problem::ESelectionScheme selection;
+		Problem::EFitnessModel fitness;
+		Problem::EDecoder decoder;
+		float selectivePressure;
+		float probCX;
+		float probMUT;
+		float probOperator;
+		float tempPopFraction; // tempPopSize wzgledem populacji
+		float replaceCoeff;
+		uint32 tourGroupSize;
+		bool allowDuplicates;
+		bool genitor;
+		bool sequence;
+
+		// wynik w kolejnych blokach (ujemny - jeszcze nie liczony)
+		std::vector<double> results;
+		bool alive;
+	};
+
+	const char* popModelNames[] = { "SIMPLE", "SS_UNIFORM", "SS_ELITISM", "SS_EXCESS" };
+	const char* selectionNames[] = { "UNIFORM", "ROULETTE", "TOURNAMENT", "SUS", "RANKING" };
+	const char* fitnessNames[] = { "LINEARRANKING", "SIGMASCALING", "RAWVALUE" };
+	const char* decoderNames[] = { "SEMIACTIVE", "ACTIVE", "GT_ACTIVE", "GT_NONDELAY" };
+
+	// Kwantyle rozkladu normalnego, chi^2 (Wilson-Hilferty) i t-Studenta (Cornish-Fisher)
+	double normalQuantile(double p)
+	{
+		// Acklam - wystarczajaco dokladne dla poziomow istotnosci testu
+		static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02,
+			-2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+		static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02,
+			-1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01 };
+		static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01,
+			-2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+		static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01,
+			2.445134137142996e+00, 3.754408661907416e+00 };
+
+		if(p < 0.02425)
+		{
+			double q = sqrt(-2.0 * log(p));
+			return (((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+				((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1.0);
+		}
+		if(p > 1.0 - 0.02425)
+			return -normalQuantile(1.0 - p);
+
+		double q = p - 0.5;
+		double r = q * q;
+		return (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5])*q /
+			(((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1.0);
+	}
+
+	double chiSquareQuantile(double p, double df)
+	{
+		double z = normalQuantile(p);
+		double h = 2.0 / (9.0 * df);
+		double x = 1.0 - h + z * sqrt(h);
+		return df * x * x * x;
+	}
+
+	double studentQuantile(double p, double df)
+	{
+		double z = normalQuantile(p);
+		double z3 = z * z * z;
+		double z5 = z3 * z * z;
+		return z + (z3 + z) / (4.0 * df) + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * df * df);
+	}
+
+	float uniform(Random& rnd)
+	{
+		return rnd.randomUnorm();
+	}
+
+	uint32 pick(Random& rnd, uint32 a, uint32 b)
+	{
+		return a < b ? rnd.random(a, b) : a;
+	}
+
+	// Wartosc z rozkladu normalnego (Box-Muller) obcieta do [lo, hi]
+	float perturb(Random& rnd, float value, float sigma, float lo, float hi)
+	{
+		float u1 = std::max(uniform(rnd), 1e-7f);
+		float u2 = uniform(rnd);
+		float n = sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+		return std::max(lo, std::min(hi, value + sigma * n));
+	}
+
+	void sampleUniform(Random& rnd, Config& c)
+	{
+		c.popModel = static_cast<Problem::EPopulationModel>(pick(rnd, 0, 3));
+		c.selection = static_cast<Problem::ESelectionScheme>(pick(rnd, 0, 4));
+		c.fitness = static_cast<Problem::EFitnessModel>(pick(rnd, 0, 2));
+		c.decoder = static_cast<Problem::EDecoder>(pick(rnd, 0, 3));
+		c.selectivePressure = 1.0f + uniform(rnd);
+		c.probCX = uniform(rnd);
+		c.probMUT = uniform(rnd);
+		c.probOperator = uniform(rnd);
+		c.tempPopFraction = 0.05f + 0.45f * uniform(rnd);
+		c.replaceCoeff = uniform(rnd);
+		c.tourGroupSize = pick(rnd, 2, 8);
+		c.allowDuplicates = uniform(rnd) < 0.5f;
+		c.genitor = uniform(rnd) < 0.5f;
+		c.sequence = uniform(rnd) < 0.5f;
+	}
+
+	// Nowa konfiguracja wokol elity - odchylenie maleje z kolejnymi iteracjami,
+	// parametr kategoryczny zmienia sie z prawdopodobienstwem 'change'
+	void sampleAround(Random& rnd, const Config& elite, float scale, Config& c)
+	{
+		float change = 0.5f * scale;
+		Config fresh;
+		sampleUniform(rnd, fresh);
+
+		c.popModel = uniform(rnd) < change ? fresh.popModel : elite.popModel;
+		c.selection = uniform(rnd) < change ? fresh.selection : elite.selection;
+		c.fitness = uniform(rnd) < change ? fresh.fitness : elite.fitness;
+		c.decoder = uniform(rnd) < change ? fresh.decoder : elite.decoder;
+		c.allowDuplicates = uniform(rnd) < change ? fresh.allowDuplicates : elite.allowDuplicates;
+		c.genitor = uniform(rnd) < change ? fresh.genitor : elite.genitor;
+		c.sequence = uniform(rnd) < change ? fresh.sequence : elite.sequence;
+
+		c.selectivePressure = perturb(rnd, elite.selectivePressure, 0.3f * scale, 1.0f, 2.0f);
+		c.probCX = perturb(rnd, elite.probCX, 0.3f * scale, 0.0f, 1.0f);
+		c.probMUT = perturb(rnd, elite.probMUT, 0.3f * scale, 0.0f, 1.0f);
+		c.probOperator = perturb(rnd, elite.probOperator, 0.3f * scale, 0.0f, 1.0f);
+		c.tempPopFraction = perturb(rnd, elite.tempPopFraction, 0.15f * scale, 0.05f, 0.5f);
+		c.replaceCoeff = perturb(rnd, elite.replaceCoeff, 0.3f * scale, 0.0f, 1.0f);
+		c.tourGroupSize = static_cast<uint32>(perturb(rnd,
+			static_cast<float>(elite.tourGroupSize), 2.0f * scale, 2.0f, 8.0f) + 0.5f);
+	}
+
+	// Jeden bieg: odleglosc od dolnego ograniczenia po budzecie dekodowan
+	double solve(const Problem& instance, const Config& c, uint32 seed, const Settings& s)
+	{
+		Problem p;
+		p.setSeed(seed);
+		if(!p.copyInitialData(instance))
+			return 1e9;
+
+		p.setPopulationModel(c.popModel);
+		p.setSelectMethod(c.selection);
+		p.setFitnessModel(c.fitness, c.selectivePressure);
+		p.setProbability(c.probCX, c.probMUT);
+		p.setOperatorProbability(c.probOperator);
+		p.setGenitor(c.genitor);
+		p.setDecoder(c.decoder);
+		p.setSequenceChromosome(c.sequence);
+
+		uint32 extra = std::max(1U, static_cast<uint32>(c.tempPopFraction * s.popSize));
+		uint32 tempPopSize = c.popModel == Problem::PM_SS_EXCESS ? s.popSize + extra : extra;
+		p.setSSParameters(tempPopSize, c.replaceCoeff, s.popSize);
+		p.generateRandomSolutions(s.popSize);
+		p.setTournamentParameters(c.tourGroupSize, c.allowDuplicates);
+
+		while(p.getDecodeCount() < s.evaluations && !p.reachedLowerBound())
+			p.nextGen();
+		return p.optimalityGap();
+	}
+
+	void printConfig(FILE* fp, const Config& c)
+	{
+		fprintf(fp, "populationModel %s\n", popModelNames[c.popModel]);
+		fprintf(fp, "selection %s\n", selectionNames[c.selection]);
+		fprintf(fp, "fitness %s\n", fitnessNames[c.fitness]);
+		fprintf(fp, "decoder %s\n", decoderNames[c.decoder]);
+		fprintf(fp, "selectivePressure %.3f\n", c.selectivePressure);
+		fprintf(fp, "crossoverRate %.3f\n", c.probCX);
+		fprintf(fp, "mutationRate %.3f\n", c.probMUT);
+		fprintf(fp, "rowColumnOperatorRate %.3f\n", c.probOperator);
+		fprintf(fp, "temporaryPopulationFraction %.3f\n", c.tempPopFraction);
+		fprintf(fp, "reinsertionCoefficient %.3f\n", c.replaceCoeff);
+		fprintf(fp, "tournamentGroupSize %u\n", c.tourGroupSize);
+		fprintf(fp, "allowDuplicates %d\n", c.allowDuplicates);
+		fprintf(fp, "genitor %d\n", c.genitor);
+		fprintf(fp, "sequenceChromosome %d\n", c.sequence);
+	}
+
+	double meanResult(const Config& c, uint32 blocks)
+	{
+		double sum = 0.0;
+		for(uint32 b = 0; b < blocks; ++b)
+			sum += c.results[b];
+		return blocks ? sum / blocks : 0.0;
+	}
+
+	// * Test Friedmana na pierwszych 'n' blokach zyjacych konfiguracji i eliminacja
+	//   istotnie gorszych od najlepszej. Zwraca liczbe wyeliminowanych
+	uint32 friedmanRace(std::vector<Config*>& alive, uint32 n, float alpha)
+	{
+		uint32 k = static_cast<uint32>(alive.size());
+		if(k < 2)
+			return 0;
+
+		// rangi w blokach (remisy - srednia ranga)
+		std::vector<double> rankSum(k, 0.0);
+		double sumSquares = 0.0;
+		std::vector<std::pair<double, uint32> > block(k);
+		for(uint32 b = 0; b < n; ++b)
+		{
+			for(uint32 j = 0; j < k; ++j)
+				block[j] = std::make_pair(alive[j]->results[b], j);
+			std::sort(block.begin(), block.end());
+
+			for(uint32 first = 0; first < k; )
+			{
+				uint32 last = first;
+				while(last + 1 < k && block[last + 1].first == block[first].first)
+					++last;
+				double rank = 0.5 * (first + last) + 1.0;
+				for(uint32 j = first; j <= last; ++j)
+				{
+					rankSum[block[j].second] += rank;
+					sumSquares += rank * rank;
+				}
+				first = last + 1;
+			}
+		}
+
+		double base = n * k * (k + 1.0) * (k + 1.0) / 4.0;
+		double spread = sumSquares - base;
+		if(spread <= 0.0)
+			return 0; // wszystkie wyniki rowne
+
+		double statistic = 0.0;
+		for(uint32 j = 0; j < k; ++j)
+		{
+			double d = rankSum[j] - n * (k + 1.0) / 2.0;
+			statistic += d * d;
+		}
+		statistic *= (k - 1.0) / spread;
+
+		if(statistic <= chiSquareQuantile(1.0 - alpha, k - 1.0))
+			return 0;
+
+		// porownania z najlepsza (najmniejsza suma rang)
+		uint32 best = static_cast<uint32>(std::min_element(rankSum.begin(), rankSum.end()) - rankSum.begin());
+		double df = (n - 1.0) * (k - 1.0);
+		double se = sqrt(2.0 * n * std::max(1.0 - statistic / (n * (k - 1.0)), 0.0) * spread / df);
+		double critical = studentQuantile(1.0 - alpha / 2.0, df) * se;
+
+		std::vector<Config*> survivors;
+		for(uint32 j = 0; j < k; ++j)
+		{
+			if(j == best || rankSum[j] - rankSum[best] <= critical)
+				survivors.push_back(alive[j]);
+			else
+				alive[j]->alive = false;
+		}
+
+		uint32 eliminated = k - static_cast<uint32>(survivors.size());
+		alive.swap(survivors);
+		return eliminated;
+	}
+
+	void usage()
+	{
+		fprintf(stderr, "usage: evotune [-configs N] [-iterations N] [-elites N] [-blocks N] [-first N]\n"
+			"               [-alpha F] [-pop N] [-evaluations N] [-seed N] [-o file] instance.dat ...\n");
+	}
+
+	bool parseArgs(int argc, char** argv, Settings& s)
+	{
+		s.numConfigs = 24;
+		s.numIterations = 3;
+		s.numElites = 4;
+		s.maxBlocks = 20;
+		s.firstTest = 5;
+		s.alpha = 0.05f;
+		s.popSize = 200;
+		s.evaluations = 40000;
+		s.seed = 1;
+		s.output = 0;
+
+		for(int i = 1; i < argc; ++i)
+		{
+			const char* arg = argv[i];
+			if(arg[0] != '-')
+			{
+				s.instances.push_back(arg);
+				continue;
+			}
+			if(i + 1 >= argc)
+			{
+				fprintf(stderr, "Error: missing value for %s\n", arg);
+				return false;
+			}
+
+			const char* value = argv[++i];
+			int n = atoi(value);
+			if(!strcmp(arg, "-o"))
+				s.output = value;
+			else if(!strcmp(arg, "-alpha"))
+				s.alpha = static_cast<float>(atof(value));
+			else if(!strcmp(arg, "-seed"))
+				s.seed = static_cast<uint32>(strtoul(value, 0, 10));
+			else if(n <= 0)
+			{
+				fprintf(stderr, "Error: bad value for %s: %s\n", arg, value);
+				return false;
+			}
+			else if(!strcmp(arg, "-configs"))
+				s.numConfigs = n;
+			else if(!strcmp(arg, "-iterations"))
+				s.numIterations = n;
+			else if(!strcmp(arg, "-elites"))
+				s.numElites = n;
+			else if(!strcmp(arg, "-blocks"))
+				s.maxBlocks = n;
+			else if(!strcmp(arg, "-first"))
+				s.firstTest = std::max(n, 2);
+			else if(!strcmp(arg, "-pop"))
+				s.popSize = n;
+			else if(!strcmp(arg, "-evaluations"))
+				s.evaluations = n;
+			else
+			{
+				fprintf(stderr, "Error: unknown option %s\n", arg);
+				return false;
+			}
+		}
+
+		if(s.alpha <= 0.0f || s.alpha >= 1.0f)
+		{
+			fprintf(stderr, "Error: alpha must be in (0, 1)\n");
+			return false;
+		}
+		return !s.instances.empty();
+	}
+}
+
+// -------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	Settings s;
+	if(!parseArgs(argc, argv, s))
+	{
+		usage();
+		return 1;
+	}
+
+	// Instancje wczytywane raz - kazdy bieg kopiuje gotowe dane
+	std::vector<Problem*> instances;
+	for(size_t i = 0; i < s.instances.size(); ++i)
+	{
+		Problem* p = new Problem();
+		if(!p->loadInitialData(s.instances[i]))
+			return 1;
+		instances.push_back(p);
+	}
+
+	// biegi rownolegle, kazdy w jednym watku
+	omp_set_nested(0);
+	double begin = omp_get_wtime();
+
+	Random rnd;
+	rnd.setGenerator(Random::GT_MERSENNE_TWISTER);
+	rnd.srand(s.seed);
+
+	std::vector<Config*> all;
+	std::vector<Config*> elites;
+	uint32 numRuns = 0;
+
+	for(uint32 it = 0; it < s.numIterations; ++it)
+	{
+		// * Step 1: elita poprzedniej iteracji (z wynikami) i nowe konfiguracje
+		std::vector<Config*> alive(elites);
+		float scale = 1.0f / (it + 1);
+		while(alive.size() < std::max(s.numConfigs, static_cast<uint32>(elites.size()) + 1))
+		{
+			Config* c = new Config();
+			c->id = static_cast<uint32>(all.size());
+			if(elites.empty())
+				sampleUniform(rnd, *c);
+			else
+				sampleAround(rnd, *elites[pick(rnd, 0, static_cast<uint32>(elites.size()) - 1)], scale, *c);
+			c->alive = true;
+			all.push_back(c);
+			alive.push_back(c);
+		}
+		for(size_t j = 0; j < alive.size(); ++j)
+			alive[j]->alive = true;
+
+		// * Step 2: wyscig
+		uint32 blocks = 0;
+		for(; blocks < s.maxBlocks && (blocks < s.firstTest || alive.size() > s.numElites); ++blocks)
+		{
+			// blok: instancja i ziarno (te same dla wszystkich konfiguracji)
+			const Problem& instance = *instances[blocks % instances.size()];
+			uint32 seed = s.seed * 7919 + blocks / static_cast<uint32>(instances.size());
+
+			std::vector<Config*> pending;
+			for(size_t j = 0; j < alive.size(); ++j)
+			{
+				if(alive[j]->results.size() <= blocks)
+				{
+					alive[j]->results.resize(blocks + 1, -1.0);
+					pending.push_back(alive[j]);
+				}
+				else if(alive[j]->results[blocks] < 0.0)
+				{
+					pending.push_back(alive[j]);
+				}
+			}
+
+			#pragma omp parallel for schedule(dynamic, 1)
+			for(int32 j = 0; j < static_cast<int32>(pending.size()); ++j)
+				pending[j]->results[blocks] = solve(instance, *pending[j], seed, s);
+			numRuns += static_cast<uint32>(pending.size());
+
+			if(blocks + 1 >= s.firstTest)
+			{
+				uint32 eliminated = friedmanRace(alive, blocks + 1, s.alpha);
+				if(eliminated)
+				{
+					fprintf(stderr, "iteration %u, block %u: %u eliminated, %u alive\n",
+						it + 1, blocks + 1, eliminated, static_cast<uint32>(alive.size()));
+				}
+			}
+		}
+
+		// * Step 3: elita - najlepsze srednie z ocalalych (na tych samych blokach)
+		std::vector<std::pair<double, Config*> > ranking;
+		for(size_t j = 0; j < alive.size(); ++j)
+			ranking.push_back(std::make_pair(meanResult(*alive[j], blocks), alive[j]));
+		std::sort(ranking.begin(), ranking.end());
+
+		elites.clear();
+		for(size_t j = 0; j < ranking.size() && j < s.numElites; ++j)
+			elites.push_back(ranking[j].second);
+
+		fprintf(stderr, "iteration %u: %u blocks, best config #%u mean gap %.4f\n",
+			it + 1, blocks, elites[0]->id, ranking[0].first);
+	}
+
+	const Config& best = *elites[0];
+	printf("# best of %u configurations, %u runs, %.1f s\n", static_cast<uint32>(all.size()),
+		numRuns, omp_get_wtime() - begin);
+	printConfig(stdout, best);
+
+	if(s.output)
+	{
+		FILE* fp = fopen(s.output, "w");
+		if(!fp)
+		{
+			fprintf(stderr, "Can't open %s for writing\n", s.output);
+			return 1;
+		}
+		printConfig(fp, best);
+		fclose(fp);
+	}
+
+	for(size_t i = 0; i < all.size(); ++i)
+		delete all[i];
+	for(size_t i = 0; i < instances.size(); ++i)
+		delete instances[i];
+	return 0;
+}
+// -------------------------------------------------------------------------
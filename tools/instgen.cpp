@@ -0,0 +1,328 @@
+// * Generator syntetycznych instancji (format Problem::loadInitialData)
+//   do testow skalowania. Wynik zalezy tylko od parametrow i ziarna.
+//
+//   instgen [opcje] plik.dat
+//     -jobs N        liczba zadan (10)
+//     -machines N    liczba maszyn (10)
+//     -ops N | A:B   operacji w zadaniu: stala lub losowa z [A, B] (5)
+//     -cost MODEL    uniform     - kazdy koszt niezalezny z [lo, hi]
+//                    correlated  - koszt bazowy operacji z [lo, hi], na maszynach
+//                                  rozrzut +-spread
+//                    machines    - koszt bazowy razy wspolczynnik szybkosci
+//                                  maszyny z [1 - spread, 1 + spread]
+//     -range LO:HI   przedzial kosztow bazowych (1:20)
+//     -spread F      rozrzut dla correlated/machines (0.3)
+//     -flex F        czesc maszyn na ktorych operacja moze byc wykonana (1.0)
+//     -penalty F     format nie ma maszyn niedozwolonych - dostaja koszt
+//                    hi * penalty (10)
+//     -seed N        ziarno generatora (1)
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <algorithm>
+
+#include "../core/Random.h"
+
+using namespace core;
+
+namespace
+{
+	enum ECostModel
+	{
+		CM_UNIFORM,
+		CM_CORRELATED,
+		CM_MACHINES
+	};
+
+	struct Settings
+	{
+		uint32 numJobs;
+		uint32 numMachines;
+		uint32 minOps;
+		uint32 maxOps;
+		ECostModel costModel;
+		uint32 minCost;
+		uint32 maxCost;
+		float spread;
+		float flexibility;
+		float penalty;
+		uint32 seed;
+		const char* filename;
+	};
+
+	// Bufor wyjsciowy - jeden fwrite na kilkadziesiat KB zamiast fprintf na liczbe
+	class Output
+	{
+	public:
+		Output(FILE* fp) : fp(fp), ok(true) { buffer.reserve(BUFFER_SIZE + 64); }
+
+		void text(const char* str)
+		{
+			buffer.insert(buffer.end(), str, str + strlen(str));
+			flushIfFull();
+		}
+
+		void number(uint32 value)
+		{
+			char digits[10];
+			int n = 0;
+			do
+			{
+				digits[n++] = static_cast<char>('0' + value % 10);
+				value /= 10;
+			} while(value);
+
+			while(n)
+				buffer.push_back(digits[--n]);
+			flushIfFull();
+		}
+
+		bool flush()
+		{
+			if(!buffer.empty() && fwrite(&buffer[0], 1, buffer.size(), fp) != buffer.size())
+				ok = false;
+			buffer.clear();
+			return ok;
+		}
+
+	private:
+		enum { BUFFER_SIZE = 1 << 16 };
+
+		FILE* fp;
+		std::vector<char> buffer;
+		bool ok;
+
+		void flushIfFull()
+		{
+			if(buffer.size() >= BUFFER_SIZE)
+				flush();
+		}
+	};
+
+	bool parseRange(const char* str, uint32& a, uint32& b)
+	{
+		int x, y;
+		if(sscanf(str, "%d:%d", &x, &y) == 2)
+		{
+			if(x < 1 || y < x)
+				return false;
+			a = x; b = y;
+			return true;
+		}
+		if(sscanf(str, "%d", &x) == 1 && x >= 1)
+		{
+			a = b = x;
+			return true;
+		}
+		return false;
+	}
+
+	void usage()
+	{
+		fprintf(stderr, "usage: instgen [-jobs N] [-machines N] [-ops N|A:B]\n"
+			"               [-cost uniform|correlated|machines] [-range LO:HI] [-spread F]\n"
+			"               [-flex F] [-penalty F] [-seed N] file.dat\n");
+	}
+
+	bool parseArgs(int argc, char** argv, Settings& s)
+	{
+		s.numJobs = 10;
+		s.numMachines = 10;
+		s.minOps = s.maxOps = 5;
+		s.costModel = CM_UNIFORM;
+		s.minCost = 1;
+		s.maxCost = 20;
+		s.spread = 0.3f;
+		s.flexibility = 1.0f;
+		s.penalty = 10.0f;
+		s.seed = 1;
+		s.filename = 0;
+
+		for(int i = 1; i < argc; ++i)
+		{
+			const char* arg = argv[i];
+			if(arg[0] != '-')
+			{
+				s.filename = arg;
+				continue;
+			}
+			if(i + 1 >= argc)
+			{
+				fprintf(stderr, "Error: missing value for %s\n", arg);
+				return false;
+			}
+
+			const char* value = argv[++i];
+			bool ok = true;
+			if(!strcmp(arg, "-jobs"))
+				ok = (s.numJobs = atoi(value)) > 0;
+			else if(!strcmp(arg, "-machines"))
+				ok = (s.numMachines = atoi(value)) > 0;
+			else if(!strcmp(arg, "-ops"))
+				ok = parseRange(value, s.minOps, s.maxOps);
+			else if(!strcmp(arg, "-range"))
+				ok = parseRange(value, s.minCost, s.maxCost);
+			else if(!strcmp(arg, "-spread"))
+				ok = (s.spread = static_cast<float>(atof(value))) >= 0.0f && s.spread < 1.0f;
+			else if(!strcmp(arg, "-flex"))
+				ok = (s.flexibility = static_cast<float>(atof(value))) > 0.0f && s.flexibility <= 1.0f;
+			else if(!strcmp(arg, "-penalty"))
+				ok = (s.penalty = static_cast<float>(atof(value))) >= 1.0f;
+			else if(!strcmp(arg, "-seed"))
+				s.seed = static_cast<uint32>(strtoul(value, 0, 10));
+			else if(!strcmp(arg, "-cost"))
+			{
+				if(!strcmp(value, "uniform"))
+					s.costModel = CM_UNIFORM;
+				else if(!strcmp(value, "correlated"))
+					s.costModel = CM_CORRELATED;
+				else if(!strcmp(value, "machines"))
+					s.costModel = CM_MACHINES;
+				else
+					ok = false;
+			}
+			else
+			{
+				fprintf(stderr, "Error: unknown option %s\n", arg);
+				return false;
+			}
+
+			if(!ok)
+			{
+				fprintf(stderr, "Error: bad value for %s: %s\n", arg, value);
+				return false;
+			}
+		}
+
+		if(!s.filename)
+			return false;
+
+		// ograniczenia solvera: numer maszyny w genie i numer zadania w sekwencji (2 bajty)
+		if(s.numJobs > 65536 || s.numMachines > 65536)
+		{
+			fprintf(stderr, "Error: at most 65536 jobs and machines\n");
+			return false;
+		}
+		return true;
+	}
+
+	// Random::random wymaga a < b
+	uint32 pick(Random& rnd, uint32 a, uint32 b)
+	{
+		return a < b ? rnd.random(a, b) : a;
+	}
+
+	uint32 scaled(uint32 base, float factor)
+	{
+		return std::max(1U, static_cast<uint32>(base * factor + 0.5f));
+	}
+}
+
+// -------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+	Settings s;
+	if(!parseArgs(argc, argv, s))
+	{
+		usage();
+		return 1;
+	}
+
+	FILE* fp = fopen(s.filename, "wb");
+	if(!fp)
+	{
+		fprintf(stderr, "Error: couldn't open \"%s\" for writing\n", s.filename);
+		return 1;
+	}
+
+	clock_t begin = clock();
+
+	Random rnd;
+	rnd.setGenerator(Random::GT_MERSENNE_TWISTER);
+	rnd.srand(s.seed);
+
+	// wspolczynniki szybkosci maszyn (CM_MACHINES)
+	std::vector<float> speed(s.numMachines, 1.0f);
+	if(s.costModel == CM_MACHINES)
+	{
+		for(uint32 m = 0; m < s.numMachines; ++m)
+			speed[m] = 1.0f - s.spread + 2.0f * s.spread * rnd.randomUnorm();
+	}
+
+	uint32 numEligible = std::max(1U, static_cast<uint32>(s.flexibility * s.numMachines + 0.5f));
+	uint32 forbiddenCost = scaled(s.maxCost, s.penalty);
+	std::vector<uint32> machines(s.numMachines);
+	std::vector<uint32> costs(s.numMachines);
+	uint64 numOps = 0;
+
+	Output out(fp);
+	out.text("magic 1337\nnumJobs ");
+	out.number(s.numJobs);
+	out.text("\nnumMachines ");
+	out.number(s.numMachines);
+	out.text("\n");
+
+	for(uint32 j = 0; j < s.numJobs; ++j)
+	{
+		uint32 ops = pick(rnd, s.minOps, s.maxOps);
+		numOps += ops;
+
+		out.text("\njob {\n\tnumOperations ");
+		out.number(ops);
+		out.text("\n");
+
+		for(uint32 k = 0; k < ops; ++k)
+		{
+			uint32 base = pick(rnd, s.minCost, s.maxCost);
+			for(uint32 m = 0; m < s.numMachines; ++m)
+			{
+				switch(s.costModel)
+				{
+				case CM_UNIFORM:
+					costs[m] = pick(rnd, s.minCost, s.maxCost);
+					break;
+				case CM_CORRELATED:
+					costs[m] = scaled(base, 1.0f - s.spread + 2.0f * s.spread * rnd.randomUnorm());
+					break;
+				case CM_MACHINES:
+					costs[m] = scaled(base, speed[m]);
+					break;
+				}
+			}
+
+			// maszyny dozwolone: pierwsze numEligible z czesciowego tasowania
+			if(numEligible < s.numMachines)
+			{
+				for(uint32 m = 0; m < s.numMachines; ++m)
+					machines[m] = m;
+				for(uint32 m = 0; m < numEligible; ++m)
+					std::swap(machines[m], machines[pick(rnd, m, s.numMachines - 1)]);
+				for(uint32 m = numEligible; m < s.numMachines; ++m)
+					costs[machines[m]] = forbiddenCost;
+			}
+
+			out.text("\t");
+			for(uint32 m = 0; m < s.numMachines; ++m)
+			{
+				out.number(costs[m]);
+				out.text(m + 1 < s.numMachines ? " " : "\n");
+			}
+		}
+		out.text("}\n");
+	}
+
+	bool ok = out.flush();
+	ok = fclose(fp) == 0 && ok;
+	if(!ok)
+	{
+		fprintf(stderr, "Error: couldn't write \"%s\"\n", s.filename);
+		return 1;
+	}
+
+	fprintf(stderr, "%s: %u jobs, %u machines, %llu operations (%.3f s)\n", s.filename,
+		s.numJobs, s.numMachines, static_cast<unsigned long long>(numOps),
+		static_cast<double>(clock() - begin) / CLOCKS_PER_SEC);
+	return 0;
+}
+// -------------------------------------------------------------------------
@@ -0,0 +1,17 @@
+#-------------------------------------------------
+#
+# Generator syntetycznych instancji do testow skalowania
+#
+#-------------------------------------------------
+
+TARGET = instgen
+TEMPLATE = app
+
+QT       -= core gui
+CONFIG   += console
+CONFIG   -= app_bundle
+
+SOURCES += instgen.cpp \
+	../core/Random.cpp
+
+HEADERS += ../core/Random.h